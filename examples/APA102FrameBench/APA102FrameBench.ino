@@ -0,0 +1,98 @@
+//
+//  "APA102FrameBench"
+//  Times FastLED.show for a strip of APA102, APA102WB and SK9822 leds of 60, 300 and 1000 leds,
+//  printing each result as a line of JSON:
+//    frame_buffer - whether FASTLED_APA102_FRAME_BUFFER was on: the frame is encoded into one
+//                   buffer and written out in one go, instead of led by led
+//    us_per_frame - best of 3 runs of FRAMES frames, encode and write out
+//    hash         - fnv-1a of the bytes captured for one frame
+//  The output is captured, not held up for its time on the wire, so this is the encode and write
+//  cost alone.  Build it twice, once with -DFASTLED_APA102_FRAME_BUFFER=1, and compare: the hashes
+//  must be the same for both.
+//
+//  The capture is the host platform's, and this only builds there.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/APA102FrameBench/APA102FrameBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o apa102framebench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HOST)
+#error "APA102FrameBench needs the host platform's spi capture"
+#endif
+
+#define MAX_LEDS 1000
+#define FRAMES 2000
+
+#if FASTLED_APA102_FRAME_BUFFER == 1
+const int gFrameBuffer = 1;
+#else
+const int gFrameBuffer = 0;
+#endif
+
+const int gCounts[] = { 60, 300, 1000 };
+
+CRGB leds[MAX_LEDS];
+uint8_t brightness[MAX_LEDS];
+
+// fnv-1a of everything captured on a pin
+uint32_t hashPin(uint8_t pin) {
+  std::vector<uint8_t> bytes = CHostTrace::bytes(pin);
+  uint32_t h = 2166136261u;
+  for(size_t i = 0; i < bytes.size(); ++i) { h = (h ^ bytes[i]) * 16777619u; }
+  return h;
+}
+
+void bench(const char *name, CLEDController & controller, uint8_t pin, bool bPerLedBrightness) {
+  for(unsigned int c = 0; c < sizeof(gCounts) / sizeof(gCounts[0]); ++c) {
+    int n = gCounts[c];
+    CLEDController *pCur = CLEDController::head();
+    while(pCur) { pCur->setLeds(leds, 0); pCur = pCur->next(); }
+    if(bPerLedBrightness) {
+      ((CBrightnessLEDController&)controller).setLeds(leds, brightness, n);
+    } else {
+      controller.setLeds(leds, n);
+    }
+
+    CHostTrace::enable(true);
+    CHostTrace::clear();
+    FastLED.show();
+    uint32_t hash = hashPin(pin);
+    CHostTrace::enable(false);
+
+    double best = 0;
+    for(int run = 0; run < 3; ++run) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for(int f = 0; f < FRAMES; ++f) { FastLED.show(); }
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+      if(run == 0 || us < best) { best = us; }
+    }
+    printf("{\"bench\":\"%s\",\"leds\":%d,\"frame_buffer\":%d,\"us_per_frame\":%.2f,\"hash\":\"%08x\"}\n",
+           name, n, gFrameBuffer, best, hash);
+  }
+}
+
+void setup() {
+  for(int i = 0; i < MAX_LEDS; ++i) {
+    leds[i] = CHSV(i * 3, 255 - (i & 63), 255);
+    brightness[i] = i & 0x1F;
+  }
+  CLEDController & apa102 = FastLED.addLeds<APA102, 5, 6, BGR, DATA_RATE_MHZ(12)>(leds, MAX_LEDS);
+  CLEDController & apa102wb = FastLED.addLeds<APA102WB, 7, 8, BGR, DATA_RATE_MHZ(12)>(leds, brightness, MAX_LEDS);
+  CLEDController & sk9822 = FastLED.addLeds<SK9822, 9, 10, BGR, DATA_RATE_MHZ(12)>(leds, MAX_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setBrightness(200);
+  bench("APA102", apa102, 5, false);
+  bench("APA102WB", apa102wb, 7, true);
+  bench("SK9822", sk9822, 9, false);
+}
+
+void loop() {}
+
+int main() {
+  setup();
+  return 0;
+}
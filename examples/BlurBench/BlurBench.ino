@@ -0,0 +1,169 @@
+//
+//  "BlurBench"
+//  Times blur2d on matrices from 16x16 up to 1024x256, printing each result as a line of JSON:
+//    old_ns    - nanoseconds per led for the carryover loops blur2d has always used, going through an
+//                XY() function for every led and down the matrix a column at a time
+//    rows_ns   - nanoseconds per led for blur2d with 16 bit sizes and no xymap, for leds in rows
+//    mapped_ns - nanoseconds per led for blur2d with 16 bit sizes and a serpentine xymap (left out for
+//                matrices of more than 65536 leds, which an xymap can't cover)
+//    ok        - whether both gave exactly the same colors as the old loops, with XY() laid out the same
+//  Sizes that don't fit in memory are reported as skipped.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/BlurBench/BlurBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o blurbench
+//  and again with -mavx2 (or -march=native) for the AVX2 version.
+//
+
+#include <FastLED.h>
+#include <stdlib.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define BENCH_LEDS 20000000UL
+#else
+#define BENCH_LEDS 200000UL
+#endif
+
+char gLine[200];
+uint16_t gWidth;
+bool gSerpentine;
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// the sort of XY() a sketch provides, rows or serpentine
+__attribute__((noinline)) uint32_t oldXY(uint16_t x, uint16_t y) {
+  if(gSerpentine && (y & 1)) { return ((uint32_t)y * gWidth) + (gWidth - 1 - x); }
+  return ((uint32_t)y * gWidth) + x;
+}
+
+// blurRows and blurColumns as they have always been, but with 16 bit sizes
+void oldBlur2d(CRGB *leds, uint16_t width, uint16_t height, fract8 blur_amount) {
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  for(uint16_t row = 0; row < height; row++) {
+    CRGB carryover = CRGB::Black;
+    for(uint16_t i = 0; i < width; i++) {
+      CRGB cur = leds[oldXY(i, row)];
+      CRGB part = cur;
+      part.nscale8(seep);
+      cur.nscale8(keep);
+      cur += carryover;
+      if(i) leds[oldXY(i - 1, row)] += part;
+      leds[oldXY(i, row)] = cur;
+      carryover = part;
+    }
+  }
+  for(uint16_t col = 0; col < width; ++col) {
+    CRGB carryover = CRGB::Black;
+    for(uint16_t i = 0; i < height; ++i) {
+      CRGB cur = leds[oldXY(col, i)];
+      CRGB part = cur;
+      part.nscale8(seep);
+      cur.nscale8(keep);
+      cur += carryover;
+      if(i) leds[oldXY(col, i - 1)] += part;
+      leds[oldXY(col, i)] = cur;
+      carryover = part;
+    }
+  }
+}
+
+// best of 3 runs of blurring BENCH_LEDS leds (at least one pass over the matrix), in hundredths of a nanosecond
+// per led, with the old loops or with blur2d and xymap.  The leds start from the same random colors each run.
+uint32_t timeBlur(CRGB *leds, const CRGB *start, uint16_t width, uint16_t height, const uint16_t *xymap, bool bOld) {
+  uint32_t n = (uint32_t)width * height;
+  uint32_t passes = (BENCH_LEDS / n) ? (BENCH_LEDS / n) : 1;
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    memcpy((void*)leds, start, n * sizeof(CRGB));
+    uint32_t t = micros();
+    for(uint32_t p = 0; p < passes; ++p) {
+      if(bOld) { oldBlur2d(leds, width, height, 64); } else { blur2d(leds, width, height, 64, xymap); }
+    }
+    uint32_t us = micros() - t;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 100000.0) / ((double)passes * n));
+}
+
+void benchSize(uint16_t width, uint16_t height) {
+  uint32_t n = (uint32_t)width * height;
+  bool bMapped = n <= 65536UL;
+  CRGB *start = (CRGB*)calloc(n, sizeof(CRGB));
+  CRGB *ref = (CRGB*)malloc(n * sizeof(CRGB));
+  CRGB *leds = (CRGB*)malloc(n * sizeof(CRGB));
+  uint16_t *xymap = bMapped ? (uint16_t*)malloc(n * sizeof(uint16_t)) : NULL;
+  if(!start || !ref || !leds || (bMapped && !xymap)) {
+    snprintf(gLine, sizeof(gLine), "{\"width\":%u,\"height\":%u,\"skipped\":true}", width, height);
+    emit(gLine);
+  } else {
+    gWidth = width;
+    random16_set_seed(1234);
+    for(uint32_t i = 0; i < n; ++i) { start[i] = CRGB(random8(), random8(), random8()); }
+
+    gSerpentine = false;
+    uint32_t oldNs100 = timeBlur(ref, start, width, height, NULL, true);
+    uint32_t rowsNs100 = timeBlur(leds, start, width, height, NULL, false);
+    bool ok = memcmp(ref, leds, n * sizeof(CRGB)) == 0;
+
+    uint32_t mappedNs100 = 0;
+    if(bMapped) {
+      gSerpentine = true;
+      for(uint16_t y = 0; y < height; ++y) {
+        for(uint16_t x = 0; x < width; ++x) { xymap[((uint32_t)y * width) + x] = oldXY(x, y); }
+      }
+      timeBlur(ref, start, width, height, NULL, true);
+      mappedNs100 = timeBlur(leds, start, width, height, xymap, false);
+      ok = ok && memcmp(ref, leds, n * sizeof(CRGB)) == 0;
+      snprintf(gLine, sizeof(gLine),
+               "{\"width\":%u,\"height\":%u,\"old_ns\":%lu.%02lu,\"rows_ns\":%lu.%02lu,\"mapped_ns\":%lu.%02lu,\"ok\":%s}",
+               width, height, (unsigned long)(oldNs100 / 100), (unsigned long)(oldNs100 % 100),
+               (unsigned long)(rowsNs100 / 100), (unsigned long)(rowsNs100 % 100),
+               (unsigned long)(mappedNs100 / 100), (unsigned long)(mappedNs100 % 100), ok ? "true" : "false");
+    } else {
+      snprintf(gLine, sizeof(gLine),
+               "{\"width\":%u,\"height\":%u,\"old_ns\":%lu.%02lu,\"rows_ns\":%lu.%02lu,\"ok\":%s}",
+               width, height, (unsigned long)(oldNs100 / 100), (unsigned long)(oldNs100 % 100),
+               (unsigned long)(rowsNs100 / 100), (unsigned long)(rowsNs100 % 100), ok ? "true" : "false");
+    }
+    emit(gLine);
+  }
+  free(start);
+  free(ref);
+  free(leds);
+  free(xymap);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  benchSize(16, 16);
+  benchSize(64, 64);
+  benchSize(128, 128);
+  benchSize(255, 255);
+  benchSize(512, 128);
+  benchSize(1024, 256);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
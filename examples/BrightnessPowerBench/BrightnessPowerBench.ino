@@ -0,0 +1,118 @@
+//
+//  "BrightnessPowerBench"
+//  Times calculate_unscaled_power_mW on leds with a per pixel 5 bit brightness (APA102WB), for
+//  interleaved CRGB5b data and for CRGB data plus a brightness array, against a plain loop summing
+//  each channel times its brightness into 32 bit totals.  Prints each result as a line of JSON:
+//    crgb5b_us - microseconds per call, on CRGB5b data
+//    bdata_us  - microseconds per call, on CRGB data plus brightness
+//    plain_us  - microseconds per call, for the plain loop on the CRGB5b data
+//    mw        - the power the leds draw at full brightness
+//    full_mw   - the same leds' power if the brightness is left out, which is what limiting used to go by
+//    ok        - whether all three came to exactly the same power
+//  "dim" is random colors at brightnesses 0-3, "mixed" at brightnesses 0-31.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/BrightnessPowerBench/BrightnessPowerBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o brightnesspowerbench
+//
+
+#include <FastLED.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define NUM_LEDS 10000
+#define RUNS 2000
+#else
+#define NUM_LEDS 200
+#define RUNS 50
+#endif
+
+CRGB5b leds5b[NUM_LEDS];
+CRGB leds[NUM_LEDS];
+uint8_t brightness[NUM_LEDS];
+char gLine[200];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// the power model of power_mgt.cpp, one pixel at a time into 32 bit totals
+uint32_t __attribute__((noinline)) plainPower(const CRGB5b *p, uint16_t n) {
+  uint32_t r = 0, g = 0, b = 0;
+  for(uint16_t i = 0; i < n; ++i) {
+    uint8_t brt = p[i].brt & 0x1F;
+    r += (uint32_t)p[i].r * brt;
+    g += (uint32_t)p[i].g * brt;
+    b += (uint32_t)p[i].b * brt;
+  }
+  return (((r / 31) * 80) >> 8) + (((g / 31) * 55) >> 8) + (((b / 31) * 75) >> 8) + (5 * (uint32_t)n);
+}
+
+enum { CRGB5B, BDATA, PLAIN };
+uint32_t gPower;
+
+// best of 3 runs of RUNS calls, in hundredths of a microsecond per call
+uint32_t timeCalls(int which) {
+  uint32_t best = 0xFFFFFFFF;
+  for(int r = 0; r < 3; ++r) {
+    uint32_t start = micros();
+    for(int run = 0; run < RUNS; ++run) {
+      switch(which) {
+        case CRGB5B: gPower = calculate_unscaled_power_mW(leds5b, NUM_LEDS); break;
+        case BDATA: gPower = calculate_unscaled_power_mW(leds, brightness, NUM_LEDS); break;
+        default: gPower = plainPower(leds5b, NUM_LEDS); break;
+      }
+    }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((uint64_t)best * 100) / RUNS);
+}
+
+void bench(const char *name, uint8_t maxBrightness) {
+  random16_set_seed(1234);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    leds[i] = CRGB(random8(), random8(), random8());
+    brightness[i] = random8(maxBrightness + 1);
+    leds5b[i] = CRGB5b(leds[i].r, leds[i].g, leds[i].b, brightness[i]);
+  }
+  uint32_t crgb5b100 = timeCalls(CRGB5B);
+  uint32_t mw = gPower;
+  uint32_t bdata100 = timeCalls(BDATA);
+  bool ok = gPower == mw;
+  uint32_t plain100 = timeCalls(PLAIN);
+  ok = ok && gPower == mw;
+  snprintf(gLine, sizeof(gLine),
+           "{\"bench\":\"%s\",\"leds\":%d,\"crgb5b_us\":%lu.%02lu,\"bdata_us\":%lu.%02lu,\"plain_us\":%lu.%02lu,\"mw\":%lu,\"full_mw\":%lu,\"ok\":%s}",
+           name, NUM_LEDS, (unsigned long)(crgb5b100 / 100), (unsigned long)(crgb5b100 % 100),
+           (unsigned long)(bdata100 / 100), (unsigned long)(bdata100 % 100), (unsigned long)(plain100 / 100),
+           (unsigned long)(plain100 % 100), (unsigned long)mw, (unsigned long)calculate_unscaled_power_mW(leds, NUM_LEDS),
+           ok ? "true" : "false");
+  emit(gLine);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  bench("dim", 3);
+  bench("mixed", 31);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,161 @@
+//
+//  "EncodeLoopBench"
+//  Times the inner loops the WS2812 (clockless) and APA102 (spi) controllers run over their
+//  PixelController to encode a frame, against the same loops written out by hand over plain CRGB
+//  data: a data pointer stepped by a run time stride and nothing else, the way PixelController was
+//  before it handled other pixel formats.  Prints each result as a line of JSON:
+//    pixel_ns - nanoseconds per led, with PixelController
+//    plain_ns - nanoseconds per led, with the hand written loop
+//    ok       - whether the two encoded exactly the same bytes
+//  The bytes are summed up rather than written out, so this is the encode cost alone.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/EncodeLoopBench/EncodeLoopBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o encodeloopbench
+//
+
+#include <FastLED.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define NUM_LEDS 1000
+#define FRAMES 5000
+#else
+#define NUM_LEDS 200
+#define FRAMES 20
+#endif
+
+CRGB leds[NUM_LEDS];
+char gLine[200];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+typedef PixelController<RGB> Pixels;
+
+// the clockless loop: dithered and scaled, the first byte of the next led loaded while the last one goes out
+uint32_t __attribute__((noinline)) ws2812Pixels(Pixels pixels) {
+  uint32_t sum = 0;
+  pixels.preStepFirstByteDithering();
+  uint8_t b = pixels.loadAndScale0();
+  while(pixels.has(1)) {
+    pixels.stepDithering();
+    sum = (sum * 31) + b;
+    b = pixels.loadAndScale1();
+    sum = (sum * 31) + b;
+    b = pixels.loadAndScale2();
+    sum = (sum * 31) + b;
+    b = pixels.advanceAndLoadAndScale0();
+  }
+  return sum;
+}
+
+static inline uint8_t ditherAndScale(uint8_t b, uint8_t d, uint8_t scale) { return scale8(b ? qadd8(b, d) : 0, scale); }
+
+uint32_t __attribute__((noinline)) ws2812Plain(Pixels pixels) {
+  const uint8_t *data = pixels.mData;
+  int advance = pixels.mAdvance;
+  int n = pixels.mLen;
+  uint8_t d[3] = { pixels.d[0], pixels.d[1], pixels.d[2] };
+  const uint8_t e[3] = { pixels.e[0], pixels.e[1], pixels.e[2] };
+  const CRGB scale = pixels.mScale;
+  uint32_t sum = 0;
+  d[0] = e[0] - d[0];
+  while(n--) {
+    uint8_t b = ditherAndScale(data[0], d[0], scale.r);
+    d[0] = e[0] - d[0]; d[1] = e[1] - d[1]; d[2] = e[2] - d[2];
+    sum = (sum * 31) + b;
+    sum = (sum * 31) + ditherAndScale(data[1], d[1], scale.g);
+    sum = (sum * 31) + ditherAndScale(data[2], d[2], scale.b);
+    data += advance;
+  }
+  return sum;
+}
+
+// the spi loop: a fixed scale per channel, no dithering
+uint32_t __attribute__((noinline)) apa102Pixels(Pixels pixels) {
+  uint8_t s0 = pixels.getScale0(), s1 = pixels.getScale1(), s2 = pixels.getScale2();
+  uint32_t sum = 0;
+  while(pixels.has(1)) {
+    sum = (sum * 31) + (0xE0 | 0x1F);
+    sum = (sum * 31) + pixels.loadAndScale0(0, s0);
+    sum = (sum * 31) + pixels.loadAndScale1(0, s1);
+    sum = (sum * 31) + pixels.loadAndScale2(0, s2);
+    pixels.stepDithering();
+    pixels.advanceData();
+  }
+  return sum;
+}
+
+uint32_t __attribute__((noinline)) apa102Plain(Pixels pixels) {
+  const uint8_t *data = pixels.mData;
+  int advance = pixels.mAdvance;
+  int n = pixels.mLen;
+  const CRGB scale = pixels.mScale;
+  uint32_t sum = 0;
+  while(n--) {
+    sum = (sum * 31) + (0xE0 | 0x1F);
+    sum = (sum * 31) + scale8(data[0], scale.r);
+    sum = (sum * 31) + scale8(data[1], scale.g);
+    sum = (sum * 31) + scale8(data[2], scale.b);
+    data += advance;
+  }
+  return sum;
+}
+
+uint32_t gSum;
+
+// best of 3 runs of FRAMES frames, in hundredths of a nanosecond per led
+uint32_t timeLoop(uint32_t (*loop)(Pixels), EDitherMode dither) {
+  CRGB scale(200, 180, 160);
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    uint32_t start = micros();
+    for(int f = 0; f < FRAMES; ++f) {
+      Pixels pixels(leds, NUM_LEDS, scale, dither);
+      gSum = loop(pixels);
+    }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((uint64_t)best * 100000) / ((uint64_t)FRAMES * NUM_LEDS));
+}
+
+void bench(const char *name, uint32_t (*pixelLoop)(Pixels), uint32_t (*plainLoop)(Pixels), EDitherMode dither) {
+  uint32_t pixel100 = timeLoop(pixelLoop, dither);
+  uint32_t pixelSum = gSum;
+  uint32_t plain100 = timeLoop(plainLoop, dither);
+  bool ok = gSum == pixelSum;
+  snprintf(gLine, sizeof(gLine), "{\"bench\":\"%s\",\"leds\":%d,\"pixel_ns\":%lu.%02lu,\"plain_ns\":%lu.%02lu,\"ok\":%s}",
+           name, NUM_LEDS, (unsigned long)(pixel100 / 100), (unsigned long)(pixel100 % 100),
+           (unsigned long)(plain100 / 100), (unsigned long)(plain100 % 100), ok ? "true" : "false");
+  emit(gLine);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(i * 7, i * 3, i * 11); }
+  bench("ws2812", ws2812Pixels, ws2812Plain, BINARY_DITHER);
+  bench("apa102", apa102Pixels, apa102Plain, DISABLE_DITHER);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,96 @@
+//
+//  "ErrorDiffusionBench"
+//  Shows NUM_LEDS WS2812B leds of a dim gradient with each dither mode, printing a line of JSON per mode:
+//    error_diffusion - whether FASTLED_ERROR_DIFFUSION was on (without it, "diffusion" is binary dithering)
+//    mode            - none, binary or diffusion
+//    us_per_frame    - best of 3 runs of FRAMES frames, without the wire capture
+//    mean_error      - how far the output averaged over FRAMES frames at 400Hz is from the exact scaled
+//                      value, in output steps, averaged over the channels
+//  Build it twice, once with -DFASTLED_ERROR_DIFFUSION=1, and compare.
+//
+//  The wire capture and virtual clock are the host platform's, and this only builds there.  From the library
+//  directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/ErrorDiffusionBench/ErrorDiffusionBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o errordiffusionbench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HOST)
+#error "ErrorDiffusionBench needs the host platform's wire capture"
+#endif
+
+#if FASTLED_ERROR_DIFFUSION == 1
+const int gErrorDiffusion = 1;
+#else
+const int gErrorDiffusion = 0;
+#endif
+
+#define NUM_LEDS 2000
+#define FRAMES 256
+#define BRIGHTNESS 60
+
+CRGB leds[NUM_LEDS];
+double gSum[NUM_LEDS * 3];
+
+double runFrames() {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int f = 0; f < FRAMES; ++f) { FastLED.show(); }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+}
+
+double meanError() {
+  CHostClock::useVirtualClock(true);
+  CHostTrace::enable(true);
+  for(int i = 0; i < NUM_LEDS * 3; ++i) { gSum[i] = 0; }
+  for(int f = 0; f < FRAMES; ++f) {
+    uint64_t start = CHostClock::nanos();
+    FastLED.show();
+    CHostClock::advance(2500000 - (CHostClock::nanos() - start));
+    const CHostTrace::Transfer *t = CHostTrace::last(0);
+    for(int i = 0; i < NUM_LEDS * 3; ++i) { gSum[i] += t->bytes[i]; }
+  }
+  CHostTrace::enable(false);
+  CHostClock::useVirtualClock(false);
+
+  double err = 0;
+  for(int i = 0; i < NUM_LEDS * 3; ++i) {
+    err += fabs(gSum[i] / FRAMES - leds[i / 3].raw[i % 3] * (BRIGHTNESS + 1) / 256.0);
+  }
+  return err / (NUM_LEDS * 3);
+}
+
+void bench(const char *name, uint8_t ditherMode) {
+  FastLED.setDither(ditherMode);
+  double best = 0;
+  for(int run = 0; run < 3; ++run) {
+    double us = runFrames();
+    if(run == 0 || us < best) { best = us; }
+  }
+  double err = meanError();
+  printf("{\"bench\":\"error_diffusion\",\"leds\":%d,\"error_diffusion\":%d,\"mode\":\"%s\",\"us_per_frame\":%.1f,\"mean_error\":%.3f}\n",
+         NUM_LEDS, gErrorDiffusion, name, best, err);
+}
+
+void setup() {
+  FastLED.addLeds<WS2812B, 0, RGB>(leds, NUM_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setBrightness(BRIGHTNESS);
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(1 + (i & 63), 1 + ((i * 3) & 63), (i >> 3) & 63); }
+  CHostTrace::enable(false);
+
+  bench("none", DISABLE_DITHER);
+  bench("binary", BINARY_DITHER);
+  bench("diffusion", ERROR_DIFFUSION_DITHER);
+}
+
+void loop() {}
+
+int main() {
+  setup();
+  return 0;
+}
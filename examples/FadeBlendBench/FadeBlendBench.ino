@@ -0,0 +1,133 @@
+//
+//  "FadeBlendBench"
+//  Times the array versions of nscale8, nscale8_video, fadeToBlackBy, fadeUsingColor, nblend and
+//  blend, which work on the led data as a run of bytes several at a time, against the per pixel
+//  loops they replaced, on a buffer of NUM_LEDS leds, printing each result as a line of JSON:
+//    old_ns   - nanoseconds per led, looping over the leds calling the CRGB member functions
+//    new_ns   - nanoseconds per led, calling the array version
+//    speedup  - old_ns / new_ns
+//    ok       - whether the array version gave exactly the same colors
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/FadeBlendBench/FadeBlendBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o fadeblendbench
+//  and again with -mavx2 (or -march=native) for the AVX2 version.
+//
+
+#include <FastLED.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define NUM_LEDS 10000
+#define PASSES 2000
+#else
+#define NUM_LEDS 1000
+#define PASSES 20
+#endif
+
+CRGB gSource[NUM_LEDS];
+CRGB gOverlay[NUM_LEDS];
+CRGB gOld[NUM_LEDS];
+CRGB gNew[NUM_LEDS];
+char gLine[160];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// the per pixel loops the array versions used to be.  They're kept out of line, as they were in the library, so
+// that the compiler can't build the scales below into them.
+#define OLD __attribute__((noinline))
+OLD void oldNscale8(CRGB *leds, uint16_t n, uint8_t scale) {
+  for(uint16_t i = 0; i < n; ++i) { leds[i].nscale8(scale); }
+}
+OLD void oldNscale8Video(CRGB *leds, uint16_t n, uint8_t scale) {
+  for(uint16_t i = 0; i < n; ++i) { leds[i].nscale8_video(scale); }
+}
+OLD void oldFadeToBlackBy(CRGB *leds, uint16_t n, uint8_t fadeBy) {
+  oldNscale8(leds, n, 255 - fadeBy);
+}
+OLD void oldFadeUsingColor(CRGB *leds, uint16_t n, const CRGB &mask) {
+  for(uint16_t i = 0; i < n; ++i) {
+    leds[i].r = scale8(leds[i].r, mask.r);
+    leds[i].g = scale8(leds[i].g, mask.g);
+    leds[i].b = scale8(leds[i].b, mask.b);
+  }
+}
+OLD void oldNblend(CRGB *existing, const CRGB *overlay, uint16_t n, fract8 amount) {
+  for(uint16_t i = 0; i < n; ++i) { nblend(existing[i], overlay[i], amount); }
+}
+OLD void oldBlend(const CRGB *src1, const CRGB *src2, CRGB *dest, uint16_t n, fract8 amount) {
+  for(uint16_t i = 0; i < n; ++i) { dest[i] = blend(src1[i], src2[i], amount); }
+}
+
+// every function under test, run on leds (and gOverlay) by old or new code
+void apply(int which, bool bNew, CRGB *leds) {
+  switch(which) {
+    case 0: if(bNew) { nscale8(leds, NUM_LEDS, 200); } else { oldNscale8(leds, NUM_LEDS, 200); } break;
+    case 1: if(bNew) { nscale8_video(leds, NUM_LEDS, 200); } else { oldNscale8Video(leds, NUM_LEDS, 200); } break;
+    case 2: if(bNew) { fadeToBlackBy(leds, NUM_LEDS, 20); } else { oldFadeToBlackBy(leds, NUM_LEDS, 20); } break;
+    case 3: if(bNew) { fadeUsingColor(leds, NUM_LEDS, CRGB(250, 200, 150)); } else { oldFadeUsingColor(leds, NUM_LEDS, CRGB(250, 200, 150)); } break;
+    case 4: if(bNew) { nblend(leds, gOverlay, NUM_LEDS, 64); } else { oldNblend(leds, gOverlay, NUM_LEDS, 64); } break;
+    case 5: if(bNew) { blend(gSource, gOverlay, leds, NUM_LEDS, 64); } else { oldBlend(gSource, gOverlay, leds, NUM_LEDS, 64); } break;
+  }
+}
+const char *gNames[] = { "nscale8", "nscale8_video", "fadeToBlackBy", "fadeUsingColor", "nblend", "blend" };
+
+// best of 3 runs of PASSES passes, in hundredths of a nanosecond per led.  The leds are put back to gSource
+// before each run, as the fades soon take everything to black.
+uint32_t timeIt(int which, bool bNew, CRGB *leds) {
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    memcpy((void*)leds, gSource, sizeof(gSource));
+    uint32_t start = micros();
+    for(int p = 0; p < PASSES; ++p) { apply(which, bNew, leds); }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 100000.0) / ((double)PASSES * NUM_LEDS));
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  random16_set_seed(1234);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    gSource[i] = CRGB(random8(), random8(), random8());
+    gOverlay[i] = CRGB(random8(), random8(), random8());
+  }
+
+  for(int which = 0; which < 6; ++which) {
+    uint32_t oldNs100 = timeIt(which, false, gOld);
+    uint32_t newNs100 = timeIt(which, true, gNew);
+    bool ok = memcmp(gOld, gNew, sizeof(gOld)) == 0;
+    if(newNs100 == 0) { newNs100 = 1; }
+    uint32_t speedup100 = (uint32_t)(((uint64_t)oldNs100 * 100) / newNs100);
+    snprintf(gLine, sizeof(gLine),
+             "{\"fn\":\"%s\",\"leds\":%d,\"old_ns\":%lu.%02lu,\"new_ns\":%lu.%02lu,\"speedup\":%lu.%02lu,\"ok\":%s}",
+             gNames[which], NUM_LEDS, (unsigned long)(oldNs100 / 100), (unsigned long)(oldNs100 % 100),
+             (unsigned long)(newNs100 / 100), (unsigned long)(newNs100 % 100),
+             (unsigned long)(speedup100 / 100), (unsigned long)(speedup100 % 100), ok ? "true" : "false");
+    emit(gLine);
+  }
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,93 @@
+//
+//  "HDR16to5bBench"
+//  Times hdr16to5b converting CRGB16 colors to CRGB5b, a whole array at a time and one pixel at a
+//  time, printing each result as a line of JSON:
+//    array_kpx_s - thousands of pixels per second, hdr16to5b on the array
+//    pixel_kpx_s - thousands of pixels per second, hdr16to5b on each pixel
+//    ok          - whether the two gave exactly the same pixels
+//  "bright" is colors spread over the whole 16 bit range, "dim" is the same colors shifted down to
+//  the bottom 8 bits, where the smallest 5 bit brightnesses get used.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/HDR16to5bBench/HDR16to5bBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o hdr16to5bbench
+//
+
+#include <FastLED.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define NUM_LEDS 4096
+#define RUNS 500
+#else
+#define NUM_LEDS 100
+#define RUNS 20
+#endif
+
+CRGB16 src[NUM_LEDS];
+CRGB5b dest[NUM_LEDS];
+CRGB5b ref[NUM_LEDS];
+char gLine[200];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+void __attribute__((noinline)) perPixel(const CRGB16 *s, CRGB5b *d, uint16_t n) {
+  for(uint16_t i = 0; i < n; ++i) { d[i] = hdr16to5b(s[i]); }
+}
+
+// best of 3, in thousands of pixels per second
+uint32_t kpxPerSecond(bool bArray) {
+  uint32_t best = 0xFFFFFFFF;
+  for(int r = 0; r < 3; ++r) {
+    uint32_t start = micros();
+    for(int run = 0; run < RUNS; ++run) {
+      if(bArray) { hdr16to5b(src, dest, NUM_LEDS); } else { perPixel(src, ref, NUM_LEDS); }
+    }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  if(best == 0) { best = 1; }
+  return (uint32_t)(((uint64_t)NUM_LEDS * RUNS * 1000) / best);
+}
+
+void bench(const char *name, uint8_t shift) {
+  random16_set_seed(1234);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    src[i] = CRGB16(random16() >> shift, random16() >> shift, random16() >> shift);
+  }
+  uint32_t array = kpxPerSecond(true);
+  uint32_t pixel = kpxPerSecond(false);
+  bool ok = memcmp(dest, ref, sizeof(dest)) == 0;
+  snprintf(gLine, sizeof(gLine), "{\"bench\":\"%s\",\"leds\":%d,\"array_kpx_s\":%lu,\"pixel_kpx_s\":%lu,\"ok\":%s}",
+           name, NUM_LEDS, (unsigned long)array, (unsigned long)pixel, ok ? "true" : "false");
+  emit(gLine);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  bench("bright", 0);
+  bench("dim", 8);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,129 @@
+//
+//  "HSV2RGBBench"
+//  Times the array versions of hsv2rgb_rainbow and hsv2rgb_spectrum, which convert runs of pixels
+//  several at a time, against converting the same pixels one at a time, for 1000, 10000 and
+//  100000 pixels, printing each result as a line of JSON:
+//    single_ns - nanoseconds per pixel, calling the single pixel function for each one
+//    batch_ns  - nanoseconds per pixel, calling the array version
+//    speedup   - single_ns / batch_ns
+//    ok        - whether the array version gave exactly the same colors
+//  Two sets of input are used: "random" hues, saturations and values, and "fill", the hue stepping
+//  along at full value and sat 240 the way fill_rainbow does it.  Sizes that don't fit in memory
+//  are reported as skipped.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/HSV2RGBBench/HSV2RGBBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o hsv2rgbbench
+//  and again with -mavx2 (or -march=native) for the AVX2 version.
+//
+
+#include <FastLED.h>
+#include <stdlib.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define BENCH_PIXELS 20000000UL
+#else
+#define BENCH_PIXELS 100000UL
+#endif
+
+char gLine[160];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+typedef void (*single_func)(const CHSV &, CRGB &);
+typedef void (*batch_func)(const CHSV *, CRGB *, int);
+
+// best of 3 runs of converting BENCH_PIXELS pixels (at least one pass over the buffer), in tenths of a
+// nanosecond per pixel
+uint32_t timeSingle(single_func f, const CHSV *in, CRGB *out, int n) {
+  uint32_t passes = (BENCH_PIXELS / n) ? (BENCH_PIXELS / n) : 1;
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    uint32_t start = micros();
+    for(uint32_t p = 0; p < passes; ++p) {
+      for(int i = 0; i < n; ++i) { f(in[i], out[i]); }
+    }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 10000.0) / ((double)passes * n));
+}
+
+uint32_t timeBatch(batch_func f, const CHSV *in, CRGB *out, int n) {
+  uint32_t passes = (BENCH_PIXELS / n) ? (BENCH_PIXELS / n) : 1;
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    uint32_t start = micros();
+    for(uint32_t p = 0; p < passes; ++p) { f(in, out, n); }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 10000.0) / ((double)passes * n));
+}
+
+void run(const char *name, single_func single, batch_func batch, const char *input, const CHSV *in, CRGB *ref, CRGB *out, int n) {
+  uint32_t singleNs10 = timeSingle(single, in, ref, n);
+  uint32_t batchNs10 = timeBatch(batch, in, out, n);
+  bool ok = memcmp(ref, out, n * sizeof(CRGB)) == 0;
+  if(batchNs10 == 0) { batchNs10 = 1; }
+  uint32_t speedup100 = (uint32_t)(((uint64_t)singleNs10 * 100) / batchNs10);
+  snprintf(gLine, sizeof(gLine),
+           "{\"fn\":\"%s\",\"input\":\"%s\",\"pixels\":%d,\"single_ns\":%lu.%lu,\"batch_ns\":%lu.%lu,\"speedup\":%lu.%02lu,\"ok\":%s}",
+           name, input, n, (unsigned long)(singleNs10 / 10), (unsigned long)(singleNs10 % 10),
+           (unsigned long)(batchNs10 / 10), (unsigned long)(batchNs10 % 10),
+           (unsigned long)(speedup100 / 100), (unsigned long)(speedup100 % 100), ok ? "true" : "false");
+  emit(gLine);
+}
+
+void benchSize(int n) {
+  CHSV *in = (CHSV*)calloc(n, sizeof(CHSV));
+  CRGB *ref = (CRGB*)malloc(n * sizeof(CRGB));
+  CRGB *out = (CRGB*)malloc(n * sizeof(CRGB));
+  if(in && ref && out) {
+    random16_set_seed(1234);
+    for(int i = 0; i < n; ++i) { in[i] = CHSV(random8(), random8(), random8()); }
+    run("rainbow", hsv2rgb_rainbow, hsv2rgb_rainbow, "random", in, ref, out, n);
+    run("spectrum", hsv2rgb_spectrum, hsv2rgb_spectrum, "random", in, ref, out, n);
+
+    for(int i = 0; i < n; ++i) { in[i] = CHSV(i * 3, 240, 255); }
+    run("rainbow", hsv2rgb_rainbow, hsv2rgb_rainbow, "fill", in, ref, out, n);
+    run("spectrum", hsv2rgb_spectrum, hsv2rgb_spectrum, "fill", in, ref, out, n);
+  } else {
+    snprintf(gLine, sizeof(gLine), "{\"pixels\":%d,\"skipped\":true}", n);
+    emit(gLine);
+  }
+  free(in);
+  free(ref);
+  free(out);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  benchSize(1000);
+  benchSize(10000);
+  benchSize(100000L);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,260 @@
+//
+//  "Lib8tionBench"
+//  Times the lib8tion math primitives and prints the cost of each one as a line of JSON,
+//  so that runs can be diffed from one commit (or one board) to the next.
+//
+//  Before it is timed, every primitive is checked against a plain C version of what it is
+//  supposed to compute (or, for the sin approximations, against floating point and the error
+//  bound they document).  A primitive whose results have changed is reported with "ok":false.
+//
+//  Each primitive is timed two ways:
+//    "scalar" - a chain of calls, each one using the result of the last (latency)
+//    "bulk"   - the same call over a 256 entry buffer (throughput)
+//  The "loop" lines are the cost of the timing loops themselves.
+//
+//  The scale8 and blend8 variants are picked with FASTLED_SCALE8_FIXED and FASTLED_BLEND_FIXED
+//  (see fastled_config.h), and both are part of the output.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/Lib8tionBench/Lib8tionBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o lib8tionbench
+//
+
+#include <FastLED.h>
+#include <math.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define BENCH_OPS 4000000UL
+#else
+#define BENCH_OPS 16384UL
+#endif
+
+volatile uint16_t gSink;
+uint16_t gOut[256];
+char gLine[128];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+void report(const char *name, const char *mode, uint32_t us, bool ok) {
+  if(us == 0) { us = 1; }
+  // tenths of a nanosecond per op, so no float formatting is needed
+  uint32_t ns10 = (uint32_t)(((double)us * 10000.0) / BENCH_OPS);
+  unsigned long opsPerSec = (unsigned long)(((double)BENCH_OPS * 1000000.0) / us);
+  snprintf(gLine, sizeof(gLine),
+           "{\"name\":\"%s\",\"mode\":\"%s\",\"ns_per_op\":%lu.%lu,\"ops_per_s\":%lu,\"ok\":%s}",
+           name, mode, (unsigned long)(ns10 / 10), (unsigned long)(ns10 % 10), opsPerSec,
+           ok ? "true" : "false");
+  emit(gLine);
+}
+
+// a chain of BENCH_OPS calls, each depending on the last (n is mixed back in so the chain can't settle on 0)
+template<class F> uint32_t timeScalar(F f) {
+  uint16_t x = 1;
+  uint32_t start = micros();
+  for(uint32_t n = 0; n < BENCH_OPS; ++n) { x = f(x, (uint8_t)n) + (uint8_t)n; }
+  uint32_t us = micros() - start;
+  gSink = x;
+  return us;
+}
+
+// BENCH_OPS independent calls, 256 at a time
+template<class F> uint32_t timeBulk(F f) {
+  uint32_t start = micros();
+  for(uint32_t r = 0; r < BENCH_OPS / 256; ++r) {
+    for(uint16_t i = 0; i < 256; ++i) { gOut[i] = f((uint16_t)((i << 8) | i), (uint8_t)r); }
+  }
+  uint32_t us = micros() - start;
+  gSink = gOut[gSink & 0xFF];
+  return us;
+}
+
+// best of 3 runs of each, to keep other things running on the machine out of the numbers
+template<class F> void bench(const char *name, bool ok, F f) {
+  uint32_t scalar = timeScalar(f), bulk = timeBulk(f);
+  for(uint8_t run = 1; run < 3; ++run) {
+    uint32_t us = timeScalar(f);
+    if(us < scalar) { scalar = us; }
+    us = timeBulk(f);
+    if(us < bulk) { bulk = us; }
+  }
+  report(name, "scalar", scalar, ok);
+  report(name, "bulk", bulk, ok);
+}
+
+//
+// Reference versions of what each primitive computes
+//
+
+uint8_t ref_scale8(uint8_t i, uint8_t scale) {
+#if FASTLED_SCALE8_FIXED == 1
+  return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+#else
+  return ((uint16_t)i * scale) >> 8;
+#endif
+}
+
+uint16_t ref_scale16(uint16_t i, uint16_t scale) {
+#if FASTLED_SCALE8_FIXED == 1
+  return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16;
+#else
+  return ((uint32_t)i * scale) >> 16;
+#endif
+}
+
+uint8_t ref_blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+#if (FASTLED_BLEND_FIXED == 1) && (FASTLED_SCALE8_FIXED == 1)
+  return ((a << 8) + b + ((int16_t)b - a) * amountOfB) >> 8;
+#elif (FASTLED_BLEND_FIXED == 1)
+  return ((uint16_t)a * (255 - amountOfB) + (uint16_t)b * amountOfB) >> 8;
+#else
+  return scale8(a, 255 - amountOfB) + scale8(b, amountOfB);
+#endif
+}
+
+bool check_scale8() {
+  for(uint16_t i = 0; i < 256; ++i) {
+    for(uint16_t s = 0; s < 256; ++s) {
+      if(scale8(i, s) != ref_scale8(i, s)) { return false; }
+    }
+  }
+  return true;
+}
+
+bool check_nscale8x3() {
+  random16_set_seed(1);
+  for(uint16_t n = 0; n < 4096; ++n) {
+    uint8_t r = random8(), g = random8(), b = random8(), s = random8();
+    uint8_t r2 = r, g2 = g, b2 = b;
+    nscale8x3(r2, g2, b2, s);
+    if(r2 != ref_scale8(r, s) || g2 != ref_scale8(g, s) || b2 != ref_scale8(b, s)) { return false; }
+  }
+  return true;
+}
+
+bool check_qadd8() {
+  for(uint16_t i = 0; i < 256; ++i) {
+    for(uint16_t j = 0; j < 256; ++j) {
+      uint16_t sum = i + j;
+      if(qadd8(i, j) != (sum > 255 ? 255 : sum)) { return false; }
+    }
+  }
+  return true;
+}
+
+bool check_blend8() {
+  for(uint16_t a = 0; a < 256; a += 3) {
+    for(uint16_t b = 0; b < 256; b += 5) {
+      for(uint16_t amount = 0; amount < 256; ++amount) {
+        if(blend8(a, b, amount) != ref_blend8(a, b, amount)) { return false; }
+      }
+    }
+  }
+  return true;
+}
+
+// sin8 is documented to be within 2% (of its 0-255 range) of (sin(x) * 128) + 128
+bool check_sin8() {
+  for(uint16_t t = 0; t < 256; ++t) {
+    float ref = (sin(t * (2 * M_PI / 256)) * 128.0) + 128.0;
+    if(fabs(sin8(t) - ref) > 5) { return false; }
+  }
+  return true;
+}
+
+// sin16 is documented to be within 0.69% of sin(x) * 32767
+bool check_sin16() {
+  for(uint32_t t = 0; t < 65536; t += 7) {
+    float ref = sin(t * (2 * M_PI / 65536)) * 32767.0;
+    if(fabs(sin16(t) - ref) > 227) { return false; }
+  }
+  return true;
+}
+
+// the AVR asm version keeps one more bit than the C version, so allow a difference of 1
+bool check_ease8InOutQuad() {
+  for(uint16_t i = 0; i < 256; ++i) {
+    uint8_t j = (i & 0x80) ? 255 - i : i;
+    uint8_t jj2 = ref_scale8(j, j) << 1;
+    if(i & 0x80) { jj2 = 255 - jj2; }
+    int16_t diff = (int16_t)ease8InOutQuad(i) - jj2;
+    if(diff < -1 || diff > 1) { return false; }
+  }
+  return true;
+}
+
+bool check_lerp15by16() {
+  random16_set_seed(2);
+  for(uint16_t n = 0; n < 4096; ++n) {
+    int16_t a = random16() & 0x7FFF, b = random16() & 0x7FFF;
+    uint16_t frac = random16();
+    int16_t ref = (b > a) ? a + ref_scale16(b - a, frac) : a - ref_scale16(a - b, frac);
+    if(lerp15by16(a, b, frac) != ref) { return false; }
+  }
+  return true;
+}
+
+bool check_beatsin16() {
+  for(uint16_t n = 0; n < 1000; ++n) {
+    uint16_t v = beatsin16(60, 1000, 2000);
+    if(v < 1000 || v > 2000) { return false; }
+  }
+  return true;
+}
+
+// random8 is the sum of the two bytes of a 16 bit LCG
+bool check_random8() {
+  uint16_t seed = 1234;
+  random16_set_seed(seed);
+  for(uint16_t n = 0; n < 4096; ++n) {
+    seed = seed * 2053 + 13849;
+    if(random8() != (uint8_t)((seed & 0xFF) + (seed >> 8))) { return false; }
+  }
+  return true;
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+
+  snprintf(gLine, sizeof(gLine), "{\"FASTLED_SCALE8_FIXED\":%d,\"FASTLED_BLEND_FIXED\":%d,\"ops\":%lu}",
+           FASTLED_SCALE8_FIXED, FASTLED_BLEND_FIXED, (unsigned long)BENCH_OPS);
+  emit(gLine);
+
+  bench("loop", true, [](uint16_t x, uint8_t n) -> uint16_t { return x ^ n; });
+  bench("scale8", check_scale8(), [](uint16_t x, uint8_t n) -> uint16_t { return scale8(x, n); });
+  bench("nscale8x3", check_nscale8x3(), [](uint16_t x, uint8_t n) -> uint16_t {
+    uint8_t r = x, g = x >> 8, b = n;
+    nscale8x3(r, g, b, n);
+    return r + g + b;
+  });
+  bench("qadd8", check_qadd8(), [](uint16_t x, uint8_t n) -> uint16_t { return qadd8(x, n); });
+  bench("blend8", check_blend8(), [](uint16_t x, uint8_t n) -> uint16_t { return blend8(x, x >> 8, n); });
+  bench("sin8", check_sin8(), [](uint16_t x, uint8_t n) -> uint16_t { return sin8(x + n); });
+  bench("sin16", check_sin16(), [](uint16_t x, uint8_t n) -> uint16_t { return sin16(x + n); });
+  bench("ease8InOutQuad", check_ease8InOutQuad(), [](uint16_t x, uint8_t n) -> uint16_t { return ease8InOutQuad(x + n); });
+  bench("lerp15by16", check_lerp15by16(), [](uint16_t x, uint8_t n) -> uint16_t { return lerp15by16(x & 0x7FFF, n << 6, x); });
+  bench("beatsin16", check_beatsin16(), [](uint16_t x, uint8_t n) -> uint16_t { return beatsin16(60, x, x + n); });
+  bench("random8", check_random8(), [](uint16_t x, uint8_t) -> uint16_t { return random8() + x; });
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,139 @@
+//
+//  "OutputMapBench"
+//  Times showing a serpentine matrix drawn in plain rows, by permuting the leds into wire order and
+//  then showing the copy, against showing the rows directly through a controller output map (see
+//  CLEDController::setOutputMap), which gathers the leds in wire order as the frame is encoded.  For
+//  a WS2812B and an APA102 controller, printing each result as a line of JSON:
+//    plain_us   - microseconds per frame showing the leds as they are, no reordering at all
+//    permute_us - microseconds per frame permuting into a second buffer, then showing that
+//    map_us     - microseconds per frame showing through the output map
+//    ok         - whether the output map put out exactly the same bytes as permute then show
+//  On the host the output is only encoded and captured, not held up for its time on the wire, so this
+//  is the encoding cost alone.
+//
+//  Output maps need FASTLED_OUTPUT_MAP set to 1 for the whole library build (see fastled_config.h).
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -DFASTLED_OUTPUT_MAP=1 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc
+//        -x c++ examples/OutputMapBench/OutputMapBench.ino -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o outputmapbench
+//
+
+#include <FastLED.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if FASTLED_OUTPUT_MAP != 1
+#error "OutputMapBench needs FASTLED_OUTPUT_MAP set to 1"
+#endif
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define WIDTH 64
+#define HEIGHT 64
+#define FRAMES 200
+#else
+#define WIDTH 16
+#define HEIGHT 16
+#define FRAMES 20
+#endif
+#define NUM_LEDS (WIDTH * HEIGHT)
+
+CRGB leds[NUM_LEDS + 1];      // drawn in rows
+CRGB wire[NUM_LEDS + 1];      // leds permuted into wire order
+uint16_t xyTable[NUM_LEDS];
+uint16_t outputMap[NUM_LEDS]; // n'th led out is leds[outputMap[n]]
+char gLine[160];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+enum { PLAIN, PERMUTE, MAPPED };
+
+void showFrame(CLEDController & controller, int mode) {
+  if(mode == PERMUTE) {
+    for(int n = 0; n < NUM_LEDS; ++n) { wire[n] = leds[outputMap[n]]; }
+  }
+  controller.showLeds(200);
+}
+
+void setMode(CLEDController & controller, int mode) {
+  controller.setLeds((mode == PERMUTE) ? wire : leds, NUM_LEDS);
+  controller.setOutputMap((mode == MAPPED) ? outputMap : NULL);
+}
+
+// best of 3 runs of FRAMES frames, in hundredths of a microsecond per frame
+uint32_t timeFrames(CLEDController & controller, int mode) {
+  setMode(controller, mode);
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    uint32_t start = micros();
+    for(int f = 0; f < FRAMES; ++f) { showFrame(controller, mode); }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((uint64_t)best * 100) / FRAMES);
+}
+
+#if defined(FASTLED_HOST)
+// the bytes a frame puts out in mode, captured
+std::vector<uint8_t> capture(CLEDController & controller, uint8_t pin, int mode) {
+  setMode(controller, mode);
+  CHostTrace::enable(true);
+  CHostTrace::clear();
+  showFrame(controller, mode);
+  CHostTrace::enable(false);
+  return CHostTrace::bytes(pin);
+}
+#endif
+
+void bench(const char *name, CLEDController & controller, uint8_t pin) {
+  bool ok = true;
+#if defined(FASTLED_HOST)
+  ok = capture(controller, pin, PERMUTE) == capture(controller, pin, MAPPED);
+#endif
+  uint32_t plain100 = timeFrames(controller, PLAIN);
+  uint32_t permute100 = timeFrames(controller, PERMUTE);
+  uint32_t mapped100 = timeFrames(controller, MAPPED);
+  snprintf(gLine, sizeof(gLine),
+           "{\"chipset\":\"%s\",\"leds\":%d,\"plain_us\":%lu.%02lu,\"permute_us\":%lu.%02lu,\"map_us\":%lu.%02lu,\"ok\":%s}",
+           name, NUM_LEDS, (unsigned long)(plain100 / 100), (unsigned long)(plain100 % 100),
+           (unsigned long)(permute100 / 100), (unsigned long)(permute100 % 100),
+           (unsigned long)(mapped100 / 100), (unsigned long)(mapped100 % 100), ok ? "true" : "false");
+  emit(gLine);
+  controller.setLeds(leds, 0);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  // the matrix is wired serpentine; the leds are drawn in rows and the output map puts them in wire order
+  XYMap(WIDTH, HEIGHT, XY_SERPENTINE, xyTable).outputMap(outputMap);
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CHSV(i * 3, 240, 255); }
+
+  CLEDController & ws2812 = FastLED.addLeds<WS2812B, 2, GRB>(leds, 0);
+  CLEDController & apa102 = FastLED.addLeds<APA102, 4, 5, BGR, DATA_RATE_MHZ(12)>(leds, 0);
+  FastLED.setDither(DISABLE_DITHER);
+#if defined(FASTLED_HOST)
+  CHostTrace::enable(false);
+#endif
+  bench("WS2812B", ws2812, 2);
+  bench("APA102", apa102, 4);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,138 @@
+//
+//  "PacingBench"
+//  Measures how evenly FastLED paces frames at a maximum refresh rate, and how much of the time
+//  between frames is left over for other work, printing each result as a line of JSON.
+//
+//  Every frame "renders" for a random 500-2000us (a stand in for reading inputs and drawing), then
+//  shows 60 WS2812B leds (1.85ms on the wire), with the refresh rate capped at 200Hz (5ms frames).
+//  Three ways of pacing the frames are compared:
+//    "busy"     - spinning on micros() until 5ms have passed since the last frame started, the way
+//                 show used to
+//    "deadline" - show's own pacing, with an idle hook doing background work in 250us chunks
+//    "late"     - the same, plus waitToRender before each frame so inputs are read as late as possible
+//  The first few frames of each (while waitToRender learns how long rendering takes) aren't counted.
+//  For each one:
+//    jitter_us  - average distance of the frame intervals from 5ms
+//    max_us     - the furthest any interval was from 5ms
+//    drift_us   - how far the last frame ended up from where 5ms frames would have put it
+//    latency_us - average time from the start of rendering (when inputs are read) to the frame going out
+//    late       - frames that went out after they were due
+//    idle_pct   - share of the time spent in the idle hook, free for other work
+//
+//  This also builds as a program on the host platform, where it runs on the virtual clock so the
+//  numbers repeat exactly.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/PacingBench/PacingBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o pacingbench
+//
+
+#include <FastLED.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#endif
+
+#define NUM_LEDS 60
+#define DATA_PIN 3
+#define FRAME_US 5000
+#define FRAMES 400
+#define WARMUP 16
+
+CRGB leds[NUM_LEDS];
+char gLine[160];
+uint32_t gIdleMicros;
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// background work, in chunks of up to 250us that never run past the deadline
+void idleWork(uint32_t slackMicros) {
+  uint32_t chunk = (slackMicros < 250) ? slackMicros : 250;
+  delayMicroseconds(chunk);
+  gIdleMicros += chunk;
+}
+
+void render(uint8_t frame) {
+  delayMicroseconds(500 + random16(1500));
+  fill_rainbow(leds, NUM_LEDS, frame, 4);
+}
+
+enum EMode { BUSY, DEADLINE, LATE };
+
+void run(const char *name, EMode mode) {
+  random16_set_seed(1234);
+  gIdleMicros = 0;
+  FastLED.setMaxRefreshRate((mode == BUSY) ? 0 : (1000000 / FRAME_US));
+  FastLED.setIdleHook((mode == BUSY) ? NULL : idleWork);
+
+  uint32_t jitterTotal = 0, jitterMax = 0, latencyTotal = 0, late = 0;
+  uint32_t first = 0, last = 0;
+  for(uint16_t frame = 0; frame <= WARMUP + FRAMES; ++frame) {
+    if(mode == LATE) { FastLED.waitToRender(); }
+    uint32_t renderStart = micros();
+    render(frame);
+
+    uint32_t start;
+    if(mode == BUSY) {
+      while((micros() - last) < FRAME_US);
+      start = micros();
+      FastLED.show();
+    } else {
+      start = micros();
+      FastLED.show();
+      int32_t slack = FastLED.getFrameSlack();
+      if(slack > 0) { start += slack; }
+      if(slack < 0 && frame > WARMUP) { ++late; }
+    }
+
+    if(frame == WARMUP) {
+      first = start;
+    } else if(frame > WARMUP) {
+      uint32_t interval = start - last;
+      uint32_t jitter = (interval > FRAME_US) ? (interval - FRAME_US) : (FRAME_US - interval);
+      jitterTotal += jitter;
+      if(jitter > jitterMax) { jitterMax = jitter; }
+      latencyTotal += start - renderStart;
+    }
+    last = start;
+  }
+
+  int32_t drift = (int32_t)(last - first) - (int32_t)FRAMES * FRAME_US;
+  snprintf(gLine, sizeof(gLine),
+           "{\"mode\":\"%s\",\"jitter_us\":%lu,\"max_us\":%lu,\"drift_us\":%ld,\"latency_us\":%lu,\"late\":%lu,\"idle_pct\":%lu}",
+           name, (unsigned long)(jitterTotal / FRAMES), (unsigned long)jitterMax, (long)drift,
+           (unsigned long)(latencyTotal / FRAMES), (unsigned long)late,
+           (unsigned long)(((uint64_t)gIdleMicros * 100) / (last - first)));
+  emit(gLine);
+}
+
+void setup() {
+#if defined(FASTLED_HOST)
+  CHostClock::useVirtualClock(true);
+  CHostTrace::enable(false);
+#else
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+
+  run("busy", BUSY);
+  run("deadline", DEADLINE);
+  run("late", LATE);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,115 @@
+//
+//  "PaletteBench"
+//  Times filling a strip from a palette one led at a time with ColorFromPalette, the way fill_palette
+//  used to, against filling it in one go with ColorsFromPalette, for each kind of RGB palette and a few
+//  strip lengths, printing each result as a line of JSON:
+//    loop_ns  - nanoseconds per led, calling ColorFromPalette for each led
+//    batch_ns - nanoseconds per led, with ColorsFromPalette
+//    ok       - whether the two gave exactly the same colors
+//  Each strip is filled stepping along the palette in 8.8 fixed point, at a brightness of 192 with
+//  linear blending.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/PaletteBench/PaletteBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o palettebench
+//
+
+#include <FastLED.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define BENCH_LEDS 2000000UL
+#define MAX_LEDS 1024
+const uint16_t gCounts[] = { 16, 32, 64, 96, 128, 256, 1024 };
+#else
+#define BENCH_LEDS 20000UL
+#define MAX_LEDS 256
+const uint16_t gCounts[] = { 16, 64, 256 };
+#endif
+
+CRGB ref[MAX_LEDS];
+CRGB leds[MAX_LEDS];
+CRGBPalette16 gPalette16;
+CRGBPalette32 gPalette32;
+CRGBPalette256 gPalette256;
+char gLine[200];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+#define BRIGHTNESS 192
+
+template<class PALETTE> __attribute__((noinline)) void fillLoop(CRGB *L, uint16_t n, const PALETTE & pal, uint16_t start, uint16_t inc) {
+  for(uint16_t i = 0; i < n; ++i) {
+    L[i] = ColorFromPalette(pal, (uint8_t)(start >> 8), BRIGHTNESS, LINEARBLEND);
+    start += inc;
+  }
+}
+
+template<class PALETTE> __attribute__((noinline)) void fillBatch(CRGB *L, uint16_t n, const PALETTE & pal, uint16_t start, uint16_t inc) {
+  ColorsFromPalette(L, n, pal, start, inc, BRIGHTNESS, LINEARBLEND);
+}
+
+// best of 3 runs of BENCH_LEDS leds, in hundredths of a nanosecond per led
+template<class PALETTE> uint32_t timeIt(bool batch, CRGB *L, uint16_t n, const PALETTE & pal) {
+  uint32_t passes = BENCH_LEDS / n;
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    uint32_t t = micros();
+    for(uint32_t p = 0; p < passes; ++p) {
+      if(batch) { fillBatch(L, n, pal, p * 300, 0x0380); } else { fillLoop(L, n, pal, p * 300, 0x0380); }
+    }
+    uint32_t us = micros() - t;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 100000.0) / ((double)passes * n));
+}
+
+template<class PALETTE> void bench(const char *name, const PALETTE & pal) {
+  for(uint8_t c = 0; c < sizeof(gCounts) / sizeof(gCounts[0]); ++c) {
+    uint16_t n = gCounts[c];
+    uint32_t loopNs100 = timeIt(false, ref, n, pal);
+    uint32_t batchNs100 = timeIt(true, leds, n, pal);
+    bool ok = memcmp(ref, leds, n * sizeof(CRGB)) == 0;
+    snprintf(gLine, sizeof(gLine),
+             "{\"palette\":\"%s\",\"leds\":%u,\"loop_ns\":%lu.%02lu,\"batch_ns\":%lu.%02lu,\"ok\":%s}",
+             name, n, (unsigned long)(loopNs100 / 100), (unsigned long)(loopNs100 % 100),
+             (unsigned long)(batchNs100 / 100), (unsigned long)(batchNs100 % 100), ok ? "true" : "false");
+    emit(gLine);
+  }
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  random16_set_seed(1234);
+  for(int i = 0; i < 16; ++i) { gPalette16[i] = CRGB(random8(), random8(), random8()); }
+  for(int i = 0; i < 32; ++i) { gPalette32[i] = CRGB(random8(), random8(), random8()); }
+  for(int i = 0; i < 256; ++i) { gPalette256[i] = CRGB(random8(), random8(), random8()); }
+
+  bench("CRGBPalette16", gPalette16);
+  bench("TProgmemRGBPalette16", RainbowColors_p);
+  bench("CRGBPalette32", gPalette32);
+  bench("CRGBPalette256", gPalette256);
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
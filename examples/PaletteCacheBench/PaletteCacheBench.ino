@@ -0,0 +1,205 @@
+//
+//  "PaletteCacheBench"
+//  Times the palette drawing of a frame of the Pacifica and TwinkleFox examples, looking colors up
+//  in their CRGBPalette16s with ColorFromPalette as they do, against looking them up in a
+//  CRGBPaletteCache of each palette, updated from the palette every frame.  Prints each result as a
+//  line of JSON:
+//    palette_us - microseconds per frame, with ColorFromPalette on the palettes
+//    cache_us   - microseconds per frame, with ColorFromPalette on caches of them, updates included
+//    rebuilds   - how many times the caches had to work their colors out again, in FRAMES frames
+//    ok         - whether the two gave exactly the same frames
+//  "pacifica" is its four layers of waves, from three fixed palettes, blended (LINEARBLEND).
+//  "twinklefox" is its twinkles, without blending (NOBLEND), from a palette that
+//  nblendPaletteTowardPalette moves a little toward a new one every frame until it gets there, the
+//  cache being worked out again for every frame the palette changes; "twinklefox_steady" is the
+//  same with a palette that doesn't change.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/PaletteCacheBench/PaletteCacheBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o palettecachebench
+//
+
+#include <FastLED.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define FRAMES 2000
+const uint16_t gCounts[] = { 60, 300, 1000 };
+#else
+#define FRAMES 50
+const uint16_t gCounts[] = { 60 };
+#endif
+#define MAX_LEDS 1000
+
+CRGB ref[MAX_LEDS];
+CRGB leds[MAX_LEDS];
+char gLine[200];
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// Pacifica's palettes, and its one layer of waves, for either a palette or a cache
+CRGBPalette16 pacifica_palette_1 =
+    { 0x000507, 0x000409, 0x00030B, 0x00030D, 0x000210, 0x000212, 0x000114, 0x000117,
+      0x000019, 0x00001C, 0x000026, 0x000031, 0x00003B, 0x000046, 0x14554B, 0x28AA50 };
+CRGBPalette16 pacifica_palette_2 =
+    { 0x000507, 0x000409, 0x00030B, 0x00030D, 0x000210, 0x000212, 0x000114, 0x000117,
+      0x000019, 0x00001C, 0x000026, 0x000031, 0x00003B, 0x000046, 0x0C5F52, 0x19BE5F };
+CRGBPalette16 pacifica_palette_3 =
+    { 0x000208, 0x00030E, 0x000514, 0x00061A, 0x000820, 0x000927, 0x000B2D, 0x000C33,
+      0x000E39, 0x001040, 0x001450, 0x001860, 0x001C70, 0x002080, 0x1040BF, 0x2060FF };
+CRGBPaletteCache pacifica_cache_1, pacifica_cache_2, pacifica_cache_3;
+
+template<class PALETTE> void pacifica_one_layer(CRGB *L, uint16_t n, const PALETTE & p, uint16_t cistart, uint16_t wavescale, uint8_t bri, uint16_t ioff) {
+  uint16_t ci = cistart;
+  uint16_t waveangle = ioff;
+  uint16_t wavescale_half = (wavescale / 2) + 20;
+  for(uint16_t i = 0; i < n; i++) {
+    waveangle += 250;
+    uint16_t s16 = sin16(waveangle) + 32768;
+    uint16_t cs = scale16(s16, wavescale_half) + wavescale_half;
+    ci += cs;
+    uint16_t sindex16 = sin16(ci) + 32768;
+    uint8_t sindex8 = scale16(sindex16, 240);
+    L[i] += ColorFromPalette(p, sindex8, bri, LINEARBLEND);
+  }
+}
+
+int gRebuilds;
+
+// the layers of one Pacifica frame, frame f of the run
+void pacificaFrame(CRGB *L, uint16_t n, uint32_t f, bool cached) {
+  uint16_t t = f * 20;
+  uint16_t ci1 = f * 2400, ci2 = 0 - (f * 1900), ci3 = 0 - (f * 1200), ci4 = 0 - (f * 1000);
+  uint16_t ws1 = (11 * 256) + (f % 768), ws2 = (6 * 256) + (f % 768);
+  uint8_t b1 = 70 + (f % 60), b2 = 40 + (f % 40), b3 = 10 + (f % 28), b4 = 10 + (f % 18);
+  fill_solid(L, n, CRGB(2, 6, 10));
+  if(cached) {
+    gRebuilds += pacifica_cache_1.update(pacifica_palette_1);
+    gRebuilds += pacifica_cache_2.update(pacifica_palette_2);
+    gRebuilds += pacifica_cache_3.update(pacifica_palette_3);
+    pacifica_one_layer(L, n, pacifica_cache_1, ci1, ws1, b1, 0 - (t * 3));
+    pacifica_one_layer(L, n, pacifica_cache_2, ci2, ws2, b2, t * 4);
+    pacifica_one_layer(L, n, pacifica_cache_3, ci3, 6 * 256, b3, 0 - (t * 5));
+    pacifica_one_layer(L, n, pacifica_cache_3, ci4, 5 * 256, b4, t * 6);
+  } else {
+    pacifica_one_layer(L, n, pacifica_palette_1, ci1, ws1, b1, 0 - (t * 3));
+    pacifica_one_layer(L, n, pacifica_palette_2, ci2, ws2, b2, t * 4);
+    pacifica_one_layer(L, n, pacifica_palette_3, ci3, 6 * 256, b3, 0 - (t * 5));
+    pacifica_one_layer(L, n, pacifica_palette_3, ci4, 5 * 256, b4, t * 6);
+  }
+}
+
+// TwinkleFox's twinkles, with its palette cross-fading toward the target every frame
+CRGBPalette16 gCurrentPalette, gTargetPalette;
+CRGBPaletteCache gCurrentCache;
+bool gFading;
+
+uint8_t attackDecayWave8(uint8_t i) {
+  if(i < 86) { return i * 3; }
+  i -= 86;
+  return 255 - (i + (i / 2));
+}
+
+template<class PALETTE> void drawTwinkles(CRGB *L, uint16_t n, const PALETTE & p, uint32_t clock32) {
+  uint16_t PRNG16 = 11337;
+  for(uint16_t i = 0; i < n; ++i) {
+    PRNG16 = (uint16_t)(PRNG16 * 2053) + 1384;
+    uint16_t myclockoffset16 = PRNG16;
+    PRNG16 = (uint16_t)(PRNG16 * 2053) + 1384;
+    uint8_t myspeedmultiplierQ5_3 = ((((PRNG16 & 0xFF) >> 4) + (PRNG16 & 0x0F)) & 0x0F) + 0x08;
+    uint32_t ms = (uint32_t)((clock32 * myspeedmultiplierQ5_3) >> 3) + myclockoffset16;
+    uint8_t salt = PRNG16 >> 8;
+
+    uint16_t ticks = ms >> 4;
+    uint8_t fastcycle8 = ticks;
+    uint16_t slowcycle16 = (ticks >> 8) + salt;
+    slowcycle16 += sin8(slowcycle16);
+    slowcycle16 = (slowcycle16 * 2053) + 1384;
+    uint8_t slowcycle8 = (slowcycle16 & 0xFF) + (slowcycle16 >> 8);
+    uint8_t bright = (((slowcycle8 & 0x0E) / 2) < 5) ? attackDecayWave8(fastcycle8) : 0;
+    uint8_t hue = slowcycle8 - salt;
+    L[i] = bright ? ColorFromPalette(p, hue, bright, NOBLEND) : CRGB(CRGB::Black);
+  }
+}
+
+void twinkleFrame(CRGB *L, uint16_t n, uint32_t f, bool cached) {
+  if(gFading) { nblendPaletteTowardPalette(gCurrentPalette, gTargetPalette, 12); }
+  if(cached) {
+    gRebuilds += gCurrentCache.update(gCurrentPalette);
+    drawTwinkles(L, n, gCurrentCache, f * 10);
+  } else {
+    drawTwinkles(L, n, gCurrentPalette, f * 10);
+  }
+}
+
+enum { PACIFICA, TWINKLEFOX, TWINKLEFOX_STEADY };
+const char *gNames[] = { "pacifica", "twinklefox", "twinklefox_steady" };
+
+// each timed run starts from the same palettes, and empty caches
+void reset(int scene) {
+  pacifica_cache_1 = pacifica_cache_2 = pacifica_cache_3 = gCurrentCache = CRGBPaletteCache();
+  gRebuilds = 0;
+  gCurrentPalette = (scene == TWINKLEFOX_STEADY) ? CRGBPalette16(RainbowColors_p) : CRGBPalette16(CloudColors_p);
+  gTargetPalette = RainbowColors_p;
+  gFading = (scene == TWINKLEFOX);
+}
+
+// best of 3 runs of FRAMES frames, in hundredths of a microsecond per frame.  A hash of every
+// frame's colors goes in hash.
+uint32_t timeFrames(int scene, CRGB *L, uint16_t n, bool cached, uint32_t & hash) {
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    reset(scene);
+    hash = 0;
+    uint32_t start = micros();
+    for(uint32_t f = 0; f < FRAMES; ++f) {
+      if(scene == PACIFICA) { pacificaFrame(L, n, f, cached); } else { twinkleFrame(L, n, f, cached); }
+      hash = (hash * 31) + L[f % n].r + (L[(f * 7) % n].g << 8) + (L[(f * 13) % n].b << 16);
+    }
+    uint32_t us = micros() - start;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((uint64_t)best * 100) / FRAMES);
+}
+
+void bench(int scene, uint16_t n) {
+  uint32_t refHash, cacheHash;
+  uint32_t palette100 = timeFrames(scene, ref, n, false, refHash);
+  uint32_t cache100 = timeFrames(scene, leds, n, true, cacheHash);
+  bool ok = (refHash == cacheHash) && (memcmp(ref, leds, n * sizeof(CRGB)) == 0);
+  snprintf(gLine, sizeof(gLine),
+           "{\"scene\":\"%s\",\"leds\":%u,\"palette_us\":%lu.%02lu,\"cache_us\":%lu.%02lu,\"rebuilds\":%d,\"ok\":%s}",
+           gNames[scene], n, (unsigned long)(palette100 / 100), (unsigned long)(palette100 % 100),
+           (unsigned long)(cache100 / 100), (unsigned long)(cache100 % 100), gRebuilds, ok ? "true" : "false");
+  emit(gLine);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  for(uint8_t c = 0; c < sizeof(gCounts) / sizeof(gCounts[0]); ++c) {
+    for(int scene = PACIFICA; scene <= TWINKLEFOX_STEADY; ++scene) { bench(scene, gCounts[c]); }
+  }
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
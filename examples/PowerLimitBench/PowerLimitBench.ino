@@ -0,0 +1,97 @@
+//
+//  "PowerLimitBench"
+//  Times FastLED.show with a power limit that brings the brightness down, for a WS2812B strip and
+//  two APA102WB strips (CRGB5b data, and CRGB data plus brightness) of 1000, 10000 and 50000 leds
+//  each, printing each result as a line of JSON:
+//    fused        - whether FASTLED_POWER_FUSED was on: the color totals are summed up as each
+//                   frame is written out, instead of in a separate pass over the leds before it
+//    us_per_frame - best of 3 runs of FRAMES frames
+//    brightness   - the brightness the limit allows
+//    ok           - whether that is the brightness a pass over the leds comes to
+//  The output is only encoded, not captured or held up for its time on the wire.  Build it twice,
+//  once with -DFASTLED_POWER_FUSED=1, and compare the times.
+//
+//  This takes far more memory than a microcontroller has, and only builds on the host platform.
+//  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/PowerLimitBench/PowerLimitBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o powerlimitbench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HOST)
+#error "PowerLimitBench needs the memory of the host platform"
+#endif
+
+#if FASTLED_POWER_FUSED == 1
+const int gFused = 1;
+#else
+const int gFused = 0;
+#endif
+
+#define MAX_LEDS 50000
+
+const int gCounts[] = { 1000, 10000, 50000 };
+
+CRGB leds[MAX_LEDS];
+CRGB5b leds5b[MAX_LEDS];
+CRGB wbLeds[MAX_LEDS];
+uint8_t brightness[MAX_LEDS];
+
+// the brightness calculate_max_brightness_for_power_mW comes to, from a pass over each controller's leds
+uint8_t brightnessFromLeds(int n, uint32_t limit) {
+  uint32_t total = 125 + calculate_unscaled_power_mW(leds, n) + calculate_unscaled_power_mW(leds5b, n)
+                 + calculate_unscaled_power_mW(wbLeds, brightness, n);
+  uint32_t requested = (total * 255) / 256;
+  return (requested > limit) ? (uint8_t)((255 * limit) / requested) : 255;
+}
+
+void setup() {
+  random16_set_seed(1234);
+  for(int i = 0; i < MAX_LEDS; ++i) {
+    leds[i] = CRGB(random8(), random8(), random8());
+    leds5b[i] = CRGB5b(random8(), random8(), random8(), random8(32));
+    wbLeds[i] = CRGB(random8(), random8(), random8());
+    brightness[i] = random8(32);
+  }
+  CLEDController & ws2812 = FastLED.addLeds<WS2812B, 3, GRB>(leds, MAX_LEDS);
+  CBrightnessLEDController & apa102wb5b = FastLED.addLeds<APA102WB, 7, 8, BGR, DATA_RATE_MHZ(12)>(leds5b, MAX_LEDS);
+  CBrightnessLEDController & apa102wb = FastLED.addLeds<APA102WB, 9, 10, BGR, DATA_RATE_MHZ(12)>(wbLeds, brightness, MAX_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setDither(DISABLE_DITHER);
+  CHostTrace::enable(false);
+
+  for(unsigned int c = 0; c < sizeof(gCounts) / sizeof(gCounts[0]); ++c) {
+    int n = gCounts[c];
+    ws2812.setLeds(leds, n);
+    apa102wb5b.setLeds(leds5b, n);
+    apa102wb.setLeds(wbLeds, brightness, n);
+    // a limit of a third of what the leds would draw at full brightness
+    uint32_t limit = (calculate_unscaled_power_mW(leds, n) + calculate_unscaled_power_mW(leds5b, n)
+                   + calculate_unscaled_power_mW(wbLeds, brightness, n)) / 3;
+    FastLED.setMaxPowerInMilliWatts(limit);
+    FastLED.show();
+
+    int frames = 2000000 / n;
+    double best = 0;
+    for(int run = 0; run < 3; ++run) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for(int f = 0; f < frames; ++f) { FastLED.show(); }
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+      if(run == 0 || us < best) { best = us; }
+    }
+    uint8_t limited = calculate_max_brightness_for_power_mW(255, limit);
+    printf("{\"bench\":\"power_limit\",\"leds\":%d,\"fused\":%d,\"us_per_frame\":%.2f,\"brightness\":%d,\"ok\":%s}\n",
+           n, gFused, best, limited, (limited == brightnessFromLeds(n, limit)) ? "true" : "false");
+  }
+}
+
+void loop() {}
+
+int main() {
+  setup();
+  return 0;
+}
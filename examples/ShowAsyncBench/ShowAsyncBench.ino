@@ -0,0 +1,92 @@
+//
+//  "ShowAsyncBench"
+//  Times a render and show loop with FastLED.show against the same loop with FastLED.showAsync,
+//  for a WS2812B, an APA102 and an APA102WB strip of NUM_LEDS leds each, with a render that takes
+//  RENDER_US microseconds.  Prints the result as a line of JSON:
+//    sync_ms  - milliseconds per frame, rendering then showing
+//    async_ms - milliseconds per frame, rendering the next frame while the last one goes out
+//    wire_ms  - the time the strips' frames take on the wire (FastLED.getWireMicros)
+//    ok       - whether showAsync put out exactly the same bytes as show, even with the leds
+//               drawn over before the frame was done going out
+//  Every write is held up for its time on the wire, the way real output would be, so at best
+//  async_ms comes down to the longer of the render and the wire time.
+//
+//  showAsync runs the output on a worker thread on the host platform, and this only builds there.
+//  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/ShowAsyncBench/ShowAsyncBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o showasyncbench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HAS_SHOW_WORKER)
+#error "ShowAsyncBench needs a platform with a show worker (the host)"
+#endif
+
+#define NUM_LEDS 1000
+#define RENDER_US 20000
+#define FRAMES 20
+
+CRGB leds[NUM_LEDS];
+CRGB apaLeds[NUM_LEDS];
+CRGB5b wbLeds[NUM_LEDS];
+
+// draw frame f, then spin out the rest of the render time
+void render(int f) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    leds[i] = CHSV(i + f, 255, 255);
+    apaLeds[i] = CRGB(f, i, 3);
+    wbLeds[i] = CRGB5b(i, f, 7, f & 0x1F);
+  }
+  while(std::chrono::steady_clock::now() - start < std::chrono::microseconds(RENDER_US)) { }
+}
+
+bool sameOutput() {
+  const uint8_t pins[] = { 3, 7, 9 };
+  std::vector<uint8_t> sync[3];
+  render(5);
+  FastLED.show();
+  for(int p = 0; p < 3; ++p) { sync[p] = CHostTrace::last(pins[p])->bytes; }
+  render(5);
+  FastLED.showAsync();
+  // the frame has to go out as it was when showAsync was called
+  fill_solid(leds, NUM_LEDS, CRGB::Red);
+  fill_solid(apaLeds, NUM_LEDS, CRGB::Blue);
+  for(int i = 0; i < NUM_LEDS; ++i) { wbLeds[i] = CRGB5b(1, 2, 3, 4); }
+  FastLED.waitShowComplete();
+  bool ok = true;
+  for(int p = 0; p < 3; ++p) { ok = ok && (CHostTrace::last(pins[p])->bytes == sync[p]); }
+  return ok;
+}
+
+void setup() {
+  FastLED.addLeds<WS2812B, 3, GRB>(leds, NUM_LEDS);
+  FastLED.addLeds<APA102, 7, 8, BGR, DATA_RATE_MHZ(1)>(apaLeds, NUM_LEDS);
+  FastLED.addLeds<APA102WB, 9, 10, BGR, DATA_RATE_MHZ(1)>(wbLeds, NUM_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  bool ok = sameOutput();
+
+  CHostTrace::enable(false);
+  CHostTrace::holdForWireTime(true);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int f = 0; f < FRAMES; ++f) { render(f); FastLED.show(); }
+  double syncMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+  start = std::chrono::steady_clock::now();
+  for(int f = 0; f < FRAMES; ++f) { render(f); FastLED.showAsync(); }
+  FastLED.waitShowComplete();
+  double asyncMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+  printf("{\"bench\":\"show_async\",\"leds\":%d,\"sync_ms\":%.2f,\"async_ms\":%.2f,\"wire_ms\":%.2f,\"ok\":%s}\n",
+         NUM_LEDS, syncMs, asyncMs, FastLED.getWireMicros() / 1000.0, ok ? "true" : "false");
+}
+
+void loop() {}
+
+int main() {
+  setup();
+  return 0;
+}
@@ -0,0 +1,117 @@
+//
+//  "ShowWorkersBench"
+//  Times FastLED.show with the controllers spread over 1 to MAX_WORKERS show workers (see
+//  FastLED.setShowWorkers), for 8, 16 and 32 strips of 512 WS2812B leds, printing each result as
+//  a line of JSON:
+//    us_per_frame - best of 3 runs of FRAMES frames
+//    speedup      - against a single worker, for the same number of strips
+//    ok           - whether every strip put out exactly the same bytes as with a single worker
+//  The output is only encoded and captured, not held up for its time on the wire, so this is the
+//  encoding cost alone: the part of show that extra workers can take on.
+//
+//  Show workers are threads on the host platform, and this only builds there.  From the library
+//  directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/ShowWorkersBench/ShowWorkersBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o showworkersbench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HAS_SHOW_POOL)
+#error "ShowWorkersBench needs a platform with show workers (the host)"
+#endif
+
+#define MAX_STRIPS 32
+#define NUM_LEDS 512
+#define MAX_WORKERS 8
+#define FRAMES 50
+
+CRGB leds[MAX_STRIPS][NUM_LEDS];
+uint32_t gReference[MAX_STRIPS];
+
+// one WS2812B controller per pin, from PIN down to pin 0
+template<uint8_t PIN> struct AddStrips {
+  static void add() {
+    FastLED.addLeds<WS2812B, PIN, GRB>(leds[PIN], NUM_LEDS);
+    AddStrips<PIN - 1>::add();
+  }
+};
+template<> struct AddStrips<0> {
+  static void add() { FastLED.addLeds<WS2812B, 0, GRB>(leds[0], NUM_LEDS); }
+};
+
+// only the first nStrips controllers get any leds
+void useStrips(int nStrips) {
+  for(int i = 0; i < MAX_STRIPS; ++i) {
+    FastLED[i].setLeds(leds[MAX_STRIPS - 1 - i], (i < nStrips) ? NUM_LEDS : 0);
+  }
+}
+
+// fnv-1a of everything captured on a pin
+uint32_t hashPin(uint8_t pin) {
+  std::vector<uint8_t> bytes = CHostTrace::bytes(pin);
+  uint32_t h = 2166136261u;
+  for(size_t i = 0; i < bytes.size(); ++i) { h = (h ^ bytes[i]) * 16777619u; }
+  return h;
+}
+
+bool matchesReference(int nStrips, bool bRecord) {
+  CHostTrace::enable(true);
+  CHostTrace::clear();
+  FastLED.show();
+  bool ok = true;
+  for(int i = 0; i < nStrips; ++i) {
+    uint32_t h = hashPin(MAX_STRIPS - 1 - i);
+    if(bRecord) { gReference[i] = h; }
+    ok = ok && (h == gReference[i]);
+  }
+  CHostTrace::enable(false);
+  return ok;
+}
+
+double timeFrames() {
+  double best = 0;
+  for(int run = 0; run < 3; ++run) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int f = 0; f < FRAMES; ++f) { FastLED.show(); }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+    if(run == 0 || us < best) { best = us; }
+  }
+  return best;
+}
+
+void setup() {
+  AddStrips<MAX_STRIPS - 1>::add();
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setDither(DISABLE_DITHER);
+  FastLED.setCorrection(TypicalLEDStrip);
+  FastLED.setBrightness(200);
+  for(int s = 0; s < MAX_STRIPS; ++s) {
+    fill_rainbow(leds[s], NUM_LEDS, s * 8, 3);
+  }
+
+  for(int nStrips = 8; nStrips <= MAX_STRIPS; nStrips *= 2) {
+    useStrips(nStrips);
+    double single = 0;
+    for(int nWorkers = 1; nWorkers <= MAX_WORKERS; nWorkers *= 2) {
+      FastLED.setShowWorkers(nWorkers);
+      bool ok = matchesReference(nStrips, nWorkers == 1);
+      double us = timeFrames();
+      if(nWorkers == 1) { single = us; }
+      printf("{\"controllers\":%d,\"workers\":%d,\"us_per_frame\":%.1f,\"speedup\":%.2f,\"ok\":%s}\n",
+             nStrips, nWorkers, us, single / us, ok ? "true" : "false");
+    }
+  }
+}
+
+void loop() {
+  delay(1000);
+}
+
+int main() {
+  setup();
+  return 0;
+}
@@ -0,0 +1,100 @@
+//
+//  "SkipUnchangedBench"
+//  Times FastLED.show for NUM_STRIPS strips of NUM_LEDS WS2812B leds, of which only the first one
+//  changes from frame to frame, printing the result as a line of JSON:
+//    skip_unchanged - whether FASTLED_SKIP_UNCHANGED was on: strips whose frame hasn't changed
+//                     aren't written out again
+//    ms_per_frame   - FRAMES frames, each write held up for its time on the wire
+//    encode_us      - best of 3 runs of FRAMES frames, without the wire time
+//    skipped        - how many strip frames were left out, over all of the runs
+//    ok             - whether every strip's last frame on the wire was its leds
+//  Build it twice, once with -DFASTLED_SKIP_UNCHANGED=1, and compare.
+//
+//  The wire capture is the host platform's, and this only builds there.  From the library
+//  directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/SkipUnchangedBench/SkipUnchangedBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o skipunchangedbench
+//
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <chrono>
+FASTLED_USING_NAMESPACE
+
+#if !defined(FASTLED_HOST)
+#error "SkipUnchangedBench needs the host platform's wire capture"
+#endif
+
+#if FASTLED_SKIP_UNCHANGED == 1
+const int gSkipUnchanged = 1;
+#else
+const int gSkipUnchanged = 0;
+#endif
+
+#define NUM_STRIPS 4
+#define NUM_LEDS 300
+#define FRAMES 50
+
+CRGB leds[NUM_STRIPS][NUM_LEDS];
+int gFrame;
+
+void render() {
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[0][i] = CHSV(i + gFrame, 255, 255); }
+  ++gFrame;
+}
+
+double runFrames() {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(int f = 0; f < FRAMES; ++f) { render(); FastLED.show(); }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+}
+
+// the strip's last frame on the wire, against its leds in GRB order
+bool lastFrameIsLeds(uint8_t pin, const CRGB *strip) {
+  const CHostTrace::Transfer *t = CHostTrace::last(pin);
+  if(t == NULL || t->bytes.size() != 3 * NUM_LEDS) { return false; }
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    if(t->bytes[3*i] != strip[i].g || t->bytes[3*i+1] != strip[i].r || t->bytes[3*i+2] != strip[i].b) { return false; }
+  }
+  return true;
+}
+
+void setup() {
+  FastLED.addLeds<WS2812B, 0, GRB>(leds[0], NUM_LEDS);
+  FastLED.addLeds<WS2812B, 1, GRB>(leds[1], NUM_LEDS);
+  FastLED.addLeds<WS2812B, 2, GRB>(leds[2], NUM_LEDS);
+  FastLED.addLeds<WS2812B, 3, GRB>(leds[3], NUM_LEDS);
+  for(int s = 1; s < NUM_STRIPS; ++s) {
+    for(int i = 0; i < NUM_LEDS; ++i) { leds[s][i] = CRGB(s * 40, i, 255 - i); }
+  }
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setDither(DISABLE_DITHER);
+  FastLED.show();
+
+  CHostTrace::enable(false);
+  double encode = 0;
+  for(int run = 0; run < 3; ++run) {
+    double us = runFrames();
+    if(run == 0 || us < encode) { encode = us; }
+  }
+  CHostTrace::enable(true);
+  CHostTrace::holdForWireTime(true);
+  double wire = runFrames();
+
+  bool ok = true;
+  for(int s = 0; s < NUM_STRIPS; ++s) { ok = ok && lastFrameIsLeds(s, leds[s]); }
+#if FASTLED_SKIP_UNCHANGED == 1
+  uint32_t skipped = FastLED.getSkippedFrames();
+#else
+  uint32_t skipped = 0;
+#endif
+  printf("{\"bench\":\"skip_unchanged\",\"strips\":%d,\"leds\":%d,\"skip_unchanged\":%d,\"ms_per_frame\":%.2f,\"encode_us\":%.2f,\"skipped\":%lu,\"ok\":%s}\n",
+         NUM_STRIPS, NUM_LEDS, gSkipUnchanged, wire / 1000, encode, (unsigned long)skipped, ok ? "true" : "false");
+}
+
+void loop() {}
+
+int main() {
+  setup();
+  return 0;
+}
@@ -0,0 +1,144 @@
+//
+//  "XYMapBench"
+//  Times blur2d, fill_2dnoise8 and fill_2dnoise16 on a serpentine matrix, going through the sketch's own
+//  XY() function (or serpentine = true for the noise fills) against going through an XYMap, printing each
+//  result as a line of JSON:
+//    xy_ns   - nanoseconds per led, with XY() (blur2d) or the serpentine flag (noise fills)
+//    map_ns  - nanoseconds per led, with a serpentine XYMap: one table load per led
+//    rows_ns - nanoseconds per led, with an XY_ROWS XYMap, which has no table at all (for comparison;
+//              its leds are in a different order)
+//    ok      - whether the serpentine XYMap gave exactly the same colors as XY() or the serpentine flag
+//  Sizes that don't fit in memory are reported as skipped.
+//
+//  This also builds as a program on the host platform.  Like an Arduino build it relies on unused
+//  sections being dropped at link time.  From the library directory:
+//    g++ -O2 -Wno-register -ffunction-sections -Wl,--gc-sections -Isrc -x c++ examples/XYMapBench/XYMapBench.ino
+//        -x none src/*.cpp src/platforms/host/*.cpp -lpthread -o xymapbench
+//
+
+#include <FastLED.h>
+#include <stdlib.h>
+#include <string.h>
+FASTLED_USING_NAMESPACE
+
+#if defined(FASTLED_HOST)
+#include <stdio.h>
+#define BENCH_LEDS 1000000UL
+const uint8_t gSizes[][2] = { { 16, 16 }, { 32, 32 }, { 64, 64 }, { 128, 128 }, { 255, 255 } };
+#else
+#define BENCH_LEDS 20000UL
+const uint8_t gSizes[][2] = { { 16, 16 }, { 32, 32 } };
+#endif
+
+char gLine[200];
+uint8_t gWidth;
+
+void emit(const char *line) {
+#if defined(FASTLED_HOST)
+  puts(line);
+#else
+  Serial.println(line);
+#endif
+}
+
+// the XY() a serpentine sketch provides, the way examples/XYMatrix does it
+__attribute__((noinline)) uint16_t XY(uint8_t x, uint8_t y) {
+  if(y & 0x01) { return (y * gWidth) + (gWidth - 1 - x); }
+  return (y * gWidth) + x;
+}
+
+enum { BLUR, NOISE8, NOISE16 };
+const char *gNames[] = { "blur2d", "fill_2dnoise8", "fill_2dnoise16" };
+
+// one pass of fn over the matrix, through XY() / the serpentine flag when xymap is NULL
+void apply(int fn, CRGB *leds, uint8_t width, uint8_t height, const XYMap *xymap, uint16_t frame) {
+  switch(fn) {
+    case BLUR:
+      if(xymap) { blur2d(leds, *xymap, 64); } else { blur2d(leds, width, height, 64); }
+      break;
+    case NOISE8:
+      if(xymap) {
+        fill_2dnoise8(leds, *xymap, 2, frame, 40, 500, 40, frame, 1, 300, 30, 700, 30, frame, false);
+      } else {
+        fill_2dnoise8(leds, width, height, true, 2, frame, 40, 500, 40, frame, 1, 300, 30, 700, 30, frame, false);
+      }
+      break;
+    case NOISE16:
+      if(xymap) {
+        fill_2dnoise16(leds, *xymap, 2, frame * 100UL, 4000, 50000, 4000, frame * 100UL, 1, 300, 30, 700, 30, frame, true);
+      } else {
+        fill_2dnoise16(leds, width, height, true, 2, frame * 100UL, 4000, 50000, 4000, frame * 100UL, 1, 300, 30, 700, 30, frame, true);
+      }
+      break;
+  }
+}
+
+// best of 3 runs of BENCH_LEDS leds (at least one pass over the matrix), in hundredths of a nanosecond per led.
+// The leds start from the same random colors each run.
+uint32_t timeIt(int fn, CRGB *leds, const CRGB *start, uint8_t width, uint8_t height, const XYMap *xymap) {
+  uint32_t n = (uint32_t)width * height;
+  uint32_t passes = (BENCH_LEDS / n) ? (BENCH_LEDS / n) : 1;
+  uint32_t best = 0xFFFFFFFF;
+  for(int run = 0; run < 3; ++run) {
+    memcpy((void*)leds, start, n * sizeof(CRGB));
+    uint32_t t = micros();
+    for(uint32_t p = 0; p < passes; ++p) { apply(fn, leds, width, height, xymap, (uint16_t)p); }
+    uint32_t us = micros() - t;
+    if(us < best) { best = us; }
+  }
+  return (uint32_t)(((double)best * 100000.0) / ((double)passes * n));
+}
+
+void benchSize(uint8_t width, uint8_t height) {
+  uint32_t n = (uint32_t)width * height;
+  CRGB *start = (CRGB*)malloc(n * sizeof(CRGB));
+  CRGB *ref = (CRGB*)malloc(n * sizeof(CRGB));
+  CRGB *leds = (CRGB*)malloc(n * sizeof(CRGB));
+  uint16_t *table = (uint16_t*)malloc(n * sizeof(uint16_t));
+  if(!start || !ref || !leds || !table) {
+    snprintf(gLine, sizeof(gLine), "{\"width\":%u,\"height\":%u,\"skipped\":true}", width, height);
+    emit(gLine);
+  } else {
+    gWidth = width;
+    XYMap serpentine(width, height, XY_SERPENTINE, table);
+    XYMap rows(width, height);
+    random16_set_seed(1234);
+    for(uint32_t i = 0; i < n; ++i) { start[i] = CRGB(random8(), random8(), random8()); }
+
+    for(int fn = BLUR; fn <= NOISE16; ++fn) {
+      uint32_t xyNs100 = timeIt(fn, ref, start, width, height, NULL);
+      uint32_t mapNs100 = timeIt(fn, leds, start, width, height, &serpentine);
+      bool ok = memcmp(ref, leds, n * sizeof(CRGB)) == 0;
+      uint32_t rowsNs100 = timeIt(fn, leds, start, width, height, &rows);
+      snprintf(gLine, sizeof(gLine),
+               "{\"fn\":\"%s\",\"width\":%u,\"height\":%u,\"xy_ns\":%lu.%02lu,\"map_ns\":%lu.%02lu,\"rows_ns\":%lu.%02lu,\"ok\":%s}",
+               gNames[fn], width, height, (unsigned long)(xyNs100 / 100), (unsigned long)(xyNs100 % 100),
+               (unsigned long)(mapNs100 / 100), (unsigned long)(mapNs100 % 100),
+               (unsigned long)(rowsNs100 / 100), (unsigned long)(rowsNs100 % 100), ok ? "true" : "false");
+      emit(gLine);
+    }
+  }
+  free(start);
+  free(ref);
+  free(leds);
+  free(table);
+}
+
+void setup() {
+#if !defined(FASTLED_HOST)
+  Serial.begin(115200);
+  delay(1000);
+#endif
+  for(uint8_t i = 0; i < sizeof(gSizes) / sizeof(gSizes[0]); ++i) { benchSize(gSizes[i][0], gSizes[i][1]); }
+}
+
+void loop() {
+  delay(1000);
+}
+
+#if defined(FASTLED_HOST)
+int main() {
+  setup();
+  return 0;
+}
+#endif
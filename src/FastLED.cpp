@@ -1,6 +1,10 @@
 #define FASTLED_INTERNAL
 #include "FastLED.h"
 
+#if defined(FASTLED_HAS_SHOW_WORKER)
+#include <stdlib.h>
+#endif
+
 
 #if defined(__SAM3X8E__)
 volatile uint32_t fuckit;
@@ -14,11 +18,59 @@ CFastLED FastLED;
 
 CLEDController *CLEDController::m_pHead = NULL;
 CLEDController *CLEDController::m_pTail = NULL;
+#if FASTLED_ADAPTIVE_DITHER != 1
+bool CLEDController::m_bDitherOff = false;
+#endif
 static uint32_t lastshow = 0;
 
 uint32_t _frame_cnt=0;
 uint32_t _retry_cnt=0;
 
+// define to 1 to warn (over Serial) when the maximum refresh rate is more frames than the wire can carry
+#ifndef WIRE_DEBUG_PRINT
+#define WIRE_DEBUG_PRINT 0
+#endif
+
+// set while a frame started by showAsync may still be going out
+static bool gShowPending = false;
+
+#if FASTLED_STATS == 1
+FASTLED_STATS_THREAD_LOCAL CLEDStats *gActiveStats = NULL;
+
+// times a frame shown on one controller for its stats, and points the output code's own stats (latch waits,
+// retries, separate encoding) at it
+class CStatsFrame {
+	CLEDStats & mStats;
+	uint32_t mStart;
+	uint32_t mOther;
+	bool mDiscard;
+
+public:
+	CStatsFrame(CLEDController *pLed) : mStats(pLed->getStats()), mDiscard(false) {
+		gActiveStats = &mStats;
+		mOther = mStats.encodeMicros + mStats.waitMicros;
+		mStart = micros();
+	}
+
+	// don't count this frame after all
+	void discard() { mDiscard = true; }
+
+	~CStatsFrame() {
+		gActiveStats = NULL;
+		if(mDiscard) { return; }
+		uint32_t elapsed = micros() - mStart;
+		uint32_t other = (mStats.encodeMicros + mStats.waitMicros) - mOther;
+		mStats.transmitMicros += (elapsed > other) ? (elapsed - other) : 0;
+		++mStats.frames;
+	}
+};
+#define STATS_FRAME(pLed) CStatsFrame statsFrame(pLed)
+#define STATS_DISCARD() statsFrame.discard()
+#else
+#define STATS_FRAME(pLed)
+#define STATS_DISCARD()
+#endif
+
 // uint32_t CRGB::Squant = ((uint32_t)((__TIME__[4]-'0') * 28))<<16 | ((__TIME__[6]-'0')*50)<<8 | ((__TIME__[7]-'0')*28);
 
 CFastLED::CFastLED() {
@@ -28,6 +80,20 @@ CFastLED::CFastLED() {
 	m_nFPS = 0;
 	m_pPowerFunc = NULL;
 	m_nPowerData = 0xFFFFFFFF;
+	m_pIdleFunc = NULL;
+	m_nFrameSlack = 0;
+	m_nRenderMicros = 0;
+	m_nRenderDev = 0;
+	m_nRenderStart = 0;
+#if FASTLED_SKIP_UNCHANGED == 1
+	m_nSkippedFrames = 0;
+	m_nKeepAlive = 0;
+#endif
+#if FASTLED_STATS == 1
+	memset8((void*)&m_Stats, 0, sizeof(m_Stats));
+	m_nStatsStart = 0;
+	m_nStatsLastFrame = 0;
+#endif
 }
 
 CLEDController &CFastLED::addLeds(CLEDController *pLed,
@@ -42,7 +108,7 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 	return *pLed;
 }
 
-CLEDController &CFastLED::addLeds(CLEDController *pLed,
+CBrightnessLEDController &CFastLED::addLeds(CBrightnessLEDController *pLed,
 								  struct CRGB *data,
 								  uint8_t *bdata,
 								  int nLedsOrOffset, int nLedsIfOffset) {
@@ -55,7 +121,7 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 	return *pLed;
 }
 
-CLEDController &CFastLED::addLeds(CLEDController *pLed,
+CBrightnessLEDController &CFastLED::addLeds(CBrightnessLEDController *pLed,
 								  struct CRGB5b *data,
 								  int nLedsOrOffset, int nLedsIfOffset) {
 	int nOffset = (nLedsIfOffset > 0) ? nLedsOrOffset : 0;
@@ -67,25 +133,381 @@ CLEDController &CFastLED::addLeds(CLEDController *pLed,
 	return *pLed;
 }
 
+#if defined(FASTLED_HAS_SHOW_POOL)
+// What show hands out to the show pool: the controllers to write out, in list order, and the jobs they make up.  A
+// job is either one controller in group 0, or all of the controllers of a nonzero group, starting from nFirst.
+struct CShowJob {
+	int nFirst;
+	uint8_t group;
+};
+
+static CLEDController **gShowList = NULL;
+static CShowJob *gShowJobs = NULL;
+static int gShowListSize = 0;
+static int gShowListCount = 0;
+static int gShowJobCount = 0;
+static uint8_t gShowGroupSeen[32];
+
+static void beginShowJobs() {
+	gShowListCount = gShowJobCount = 0;
+	memset8(gShowGroupSeen, 0, sizeof(gShowGroupSeen));
+}
+
+static void queueShowJob(CLEDController *pCur) {
+	if(gShowListCount == gShowListSize) {
+		gShowListSize += 8;
+		gShowList = (CLEDController**)realloc(gShowList, sizeof(CLEDController*) * gShowListSize);
+		gShowJobs = (CShowJob*)realloc(gShowJobs, sizeof(CShowJob) * gShowListSize);
+	}
+	uint8_t group = pCur->getShowGroup();
+	if(!group || !(gShowGroupSeen[group >> 3] & (1 << (group & 7)))) {
+		gShowGroupSeen[group >> 3] |= (1 << (group & 7));
+		gShowJobs[gShowJobCount].nFirst = gShowListCount;
+		gShowJobs[gShowJobCount].group = group;
+		++gShowJobCount;
+	}
+	gShowList[gShowListCount++] = pCur;
+}
+
+// runs on one of the show pool's workers
+static void showJob(void *pScale, int nJob) {
+	uint8_t scale = *(uint8_t*)pScale;
+	CShowJob & job = gShowJobs[nJob];
+	for(int i = job.nFirst; i < gShowListCount; ++i) {
+		CLEDController *pCur = gShowList[i];
+		if(pCur->getShowGroup() != job.group) { continue; }
+		STATS_FRAME(pCur);
+		pCur->showLeds(scale);
+		if(!job.group) { break; }
+	}
+}
+#endif
+
+void CFastLED::setShowWorkers(int nWorkers) {
+#if defined(FASTLED_HAS_SHOW_POOL)
+	CShowPool::setWorkers(nWorkers);
+#else
+	(void)nWorkers;
+#endif
+}
+
+// call the idle hook, or yield, until deadline (in micros) comes around
+uint32_t CFastLED::idleUntil(uint32_t deadline) {
+	uint32_t now = micros();
+	int32_t left;
+	while((left = (int32_t)(deadline - now)) > 0) {
+		if(m_pIdleFunc) {
+			(*m_pIdleFunc)(left);
+		} else {
+			yield();
+		}
+		now = micros();
+	}
+	return now;
+}
+
+// wait for the next frame to be due, and start it.  Frames are due every m_nMinMicros, counting from when the last
+// one was due rather than when it was shown, so that waking up late from the idle hook doesn't make the frame rate
+// drift.  Once a frame is more than a whole frame time late, counting starts over from it.
+uint32_t CFastLED::waitForFrame() {
+	uint32_t now = micros();
+	if(m_nRenderStart) {
+		// running average and deviation, the way TCP estimates round trip times
+		uint32_t render = now - m_nRenderStart;
+		if(m_nRenderMicros) {
+			uint32_t dev = (render > m_nRenderMicros) ? (render - m_nRenderMicros) : (m_nRenderMicros - render);
+			m_nRenderDev = (m_nRenderDev * 3 + dev) / 4;
+			m_nRenderMicros = (m_nRenderMicros * 7 + render) / 8;
+		} else {
+			m_nRenderMicros = render;
+			m_nRenderDev = render / 2;
+		}
+		m_nRenderStart = 0;
+	}
+	if(!m_nMinMicros) {
+		m_nFrameSlack = 0;
+		lastshow = now;
+		return now;
+	}
+
+	uint32_t deadline = lastshow + m_nMinMicros;
+	m_nFrameSlack = (int32_t)(deadline - now);
+	now = idleUntil(deadline);
+	lastshow = ((now - deadline) < m_nMinMicros) ? deadline : now;
+	return now;
+}
+
+void CFastLED::waitToRender() {
+	if(m_nMinMicros) {
+		// leave room for frames that take longer than usual to render: 3 deviations over the average keeps
+		// all but ~1% of frames on time in PacingBench
+		idleUntil(lastshow + m_nMinMicros - (m_nRenderMicros + 3 * m_nRenderDev));
+	}
+	m_nRenderStart = micros() | 1;
+}
+
+// switch controllers fed from frame buffers over to the newest published frames, before anything looks at the led data
+static void latchFrames() {
+#if FASTLED_TRIPLE_BUFFER == 1
+	for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+		pCur->latchFrame();
+	}
+#endif
+}
+
 void CFastLED::show(uint8_t scale) {
+	waitShowComplete();
+	statsShowStart();
+
 	// guard against showing too rapidly
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	statsFrameStart(waitForFrame());
+	latchFrames();
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
 	}
+	limitDither();
+	findUnchanged(scale);
 
 	CLEDController *pCur = CLEDController::head();
+#if defined(FASTLED_HAS_SHOW_POOL)
+	if(CShowPool::workers() > 1) {
+		// spread the controllers over the show workers, and wait for all of them to be written out
+		beginShowJobs();
+		for(; pCur; pCur = pCur->next()) {
+			if(!skipUnchanged(pCur)) {
+				queueShowJob(pCur);
+			}
+		}
+		CShowPool::run(showJob, &scale, gShowJobCount);
+	}
+#endif
 	while(pCur) {
-		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
-		pCur->showLeds(scale);
-		pCur->setDither(d);
+		if(!skipUnchanged(pCur)) {
+			STATS_FRAME(pCur);
+			pCur->showLeds(scale);
+		}
+		pCur = pCur->next();
+	}
+	countFPS();
+	statsShowEnd();
+}
+
+#if FASTLED_SKIP_UNCHANGED == 1
+// murmur3 style hash of len bytes, a word at a time (the data isn't necessarily aligned)
+static uint32_t hashBytes(uint32_t h, const uint8_t *p, int len) {
+	while(len >= 4) {
+		uint32_t k;
+		memcpy(&k, p, 4);
+		k *= 0xcc9e2d51; k = (k << 15) | (k >> 17); k *= 0x1b873593;
+		h ^= k; h = (h << 13) | (h >> 19); h = h * 5 + 0xe6546b64;
+		p += 4;
+		len -= 4;
+	}
+	while(len--) {
+		h ^= *p++;
+		h *= 0x01000193;
+	}
+	h ^= h >> 16; h *= 0x85ebca6b; h ^= h >> 13;
+	return h;
+}
+
+// returns true if pLed would write out the same frame as last time (and the keep alive hasn't run out), otherwise
+// records this frame as the one being written out and returns false
+bool CFastLED::unchangedFrame(CLEDController *pLed, uint8_t scale) {
+	CRGB adj = pLed->getAdjustment(scale);
+	int nLeds = pLed->size();
+	int nCount = nLeds < 0 ? -nLeds : nLeds;
+
+	// with dithering on, the output changes from frame to frame even when the data doesn't (unless it's all black)
+	if(pLed->getDitherBits() && (adj.r || adj.g || adj.b)) {
+		pLed->m_bFrameValid = false;
+		return false;
+	}
+
+	uint32_t h = hashBytes(0, (const uint8_t*)&nLeds, sizeof(nLeds));
+	h = hashBytes(h, adj.raw, 3);
+	if(pLed->leds5b()) {
+		h = hashBytes(h, (const uint8_t*)pLed->leds5b(), sizeof(CRGB5b) * nCount);
+	} else if(pLed->leds()) {
+		h = hashBytes(h, (const uint8_t*)pLed->leds(), sizeof(CRGB) * nCount);
+	}
+	if(pLed->brightnessData()) {
+		h = hashBytes(h, pLed->brightnessData(), nCount);
+	}
+
+	uint32_t now = millis();
+	if(pLed->m_bFrameValid && pLed->m_nFrameHash == h && (!m_nKeepAlive || (now - pLed->m_nFrameMillis) < m_nKeepAlive)) {
+		++m_nSkippedFrames;
+		return true;
+	}
+	pLed->m_nFrameHash = h;
+	pLed->m_nFrameMillis = now;
+	pLed->m_bFrameValid = true;
+	return false;
+}
+
+// works out which controllers this frame can leave out.  Controllers that go out in one batch (see
+// CLEDController::showsInBatch) don't start sending until every one of them has been shown, so if any of them has
+// changed, all of them are shown.
+void CFastLED::findUnchanged(uint8_t scale) {
+	bool bBatchChanged = false;
+	for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+		pCur->m_bSkipFrame = unchangedFrame(pCur, scale);
+		if(!pCur->m_bSkipFrame && pCur->showsInBatch()) { bBatchChanged = true; }
+	}
+	if(bBatchChanged) {
+		for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+			if(pCur->m_bSkipFrame && pCur->showsInBatch()) {
+				pCur->m_bSkipFrame = false;
+				pCur->m_nFrameMillis = millis();
+				--m_nSkippedFrames;
+			}
+		}
+	}
+#if FASTLED_ADAPTIVE_DITHER == 1
+	// a frame left out still counts towards the frame interval, or a strip that has stopped changing would keep
+	// the dither cycle sized for its last written frame
+	for(CLEDController *pCur = CLEDController::head(); pCur; pCur = pCur->next()) {
+		if(pCur->m_bSkipFrame) { pCur->timeFrame(); }
+	}
+#endif
+}
+#endif
+
+#if defined(FASTLED_HAS_SHOW_WORKER)
+// A copy of one controller's led data, taken by showAsync and written out from the show worker
+struct CShowSnapshot {
+	CLEDController *pController;
+	uint8_t *pData;			// CRGB, or CRGB5b when b5b is set
+	uint8_t *pBright;		// separate brightness data, when bBright is set
+	int nDataSize, nBrightSize;	// allocated sizes, the buffers are reused from frame to frame
+	int nLeds;
+	bool b5b;
+	bool bBright;
+	uint8_t scale;
+};
+
+static CShowSnapshot *gSnapshots = NULL;
+static int gSnapshotCount = 0;
+static int gSnapshotSize = 0;
+
+static uint8_t *snapshotBuffer(uint8_t *pBuf, int & nHave, int nNeed) {
+	if(nNeed > nHave) {
+		pBuf = (uint8_t*)realloc(pBuf, nNeed);
+		nHave = nNeed;
+	}
+	return pBuf;
+}
+
+static void queueSnapshot(CLEDController *pCur, uint8_t scale) {
+	if(gSnapshotCount == gSnapshotSize) {
+		gSnapshots = (CShowSnapshot*)realloc(gSnapshots, sizeof(CShowSnapshot) * (gSnapshotSize + 4));
+		memset(gSnapshots + gSnapshotSize, 0, sizeof(CShowSnapshot) * 4);
+		gSnapshotSize += 4;
+	}
+	CShowSnapshot & snap = gSnapshots[gSnapshotCount++];
+	int nLeds = pCur->size();
+	int nCount = nLeds < 0 ? -nLeds : nLeds;
+
+	snap.pController = pCur;
+	snap.nLeds = nLeds;
+	snap.scale = scale;
+	snap.b5b = (pCur->leds5b() != NULL);
+	if(snap.b5b) {
+		snap.pData = snapshotBuffer(snap.pData, snap.nDataSize, sizeof(CRGB5b) * nCount);
+		memcpy(snap.pData, pCur->leds5b(), sizeof(CRGB5b) * nCount);
+	} else {
+		snap.pData = snapshotBuffer(snap.pData, snap.nDataSize, sizeof(CRGB) * nCount);
+		memcpy(snap.pData, pCur->leds(), sizeof(CRGB) * nCount);
+	}
+	snap.bBright = (pCur->brightnessData() != NULL);
+	if(snap.bBright) {
+		snap.pBright = snapshotBuffer(snap.pBright, snap.nBrightSize, nCount);
+		memcpy(snap.pBright, pCur->brightnessData(), nCount);
+	}
+}
+
+// runs on the show worker
+static void showSnapshots(void *) {
+	for(int i = 0; i < gSnapshotCount; ++i) {
+		CShowSnapshot & snap = gSnapshots[i];
+		CLEDController *pCur = snap.pController;
+		STATS_FRAME(pCur);
+		// only CBrightnessLEDControllers have 5b or brightness data
+		if(snap.b5b) {
+			static_cast<CBrightnessLEDController*>(pCur)->show((CRGB5b*)snap.pData, snap.nLeds, snap.scale);
+		} else if(snap.bBright) {
+			static_cast<CBrightnessLEDController*>(pCur)->show((CRGB*)snap.pData, snap.pBright, snap.nLeds, snap.scale);
+		} else {
+			pCur->show((CRGB*)snap.pData, snap.nLeds, snap.scale);
+		}
+	}
+}
+#endif
+
+void CFastLED::showAsync(uint8_t scale) {
+	waitShowComplete();
+	statsShowStart();
+
+	// guard against showing too rapidly
+	statsFrameStart(waitForFrame());
+	latchFrames();
+
+	// If we have a function for computing power, use it!
+	if(m_pPowerFunc) {
+		scale = (*m_pPowerFunc)(scale, m_nPowerData);
+	}
+	limitDither();
+	findUnchanged(scale);
+
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		if(skipUnchanged(pCur)) {
+			pCur = pCur->next();
+			continue;
+		}
+		STATS_FRAME(pCur);
+		if(!pCur->showLedsAsync(scale)) {
+#if defined(FASTLED_HAS_SHOW_WORKER)
+			if(pCur->leds() || pCur->leds5b()) {
+				// timed on the worker instead
+				STATS_DISCARD();
+				queueSnapshot(pCur, scale);
+				pCur = pCur->next();
+				continue;
+			}
+#endif
+			pCur->showLeds(scale);
+		}
 		pCur = pCur->next();
 	}
+
+#if defined(FASTLED_HAS_SHOW_WORKER)
+	if(gSnapshotCount) {
+		CShowWorker::start(showSnapshots, NULL);
+	}
+#endif
+	gShowPending = true;
 	countFPS();
+	statsShowEnd();
+}
+
+void CFastLED::waitShowComplete() {
+	if(!gShowPending) { return; }
+#if defined(FASTLED_HAS_SHOW_WORKER)
+	if(gSnapshotCount) {
+		CShowWorker::wait();
+		gSnapshotCount = 0;
+	}
+#endif
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		pCur->waitShowComplete();
+		pCur = pCur->next();
+	}
+	gShowPending = false;
 }
 
 int CFastLED::count() {
@@ -111,23 +533,28 @@ CLEDController & CFastLED::operator[](int x) {
 }
 
 void CFastLED::showColor(const struct CRGB & color, uint8_t scale) {
-	while(m_nMinMicros && ((micros()-lastshow) < m_nMinMicros));
-	lastshow = micros();
+	waitShowComplete();
+	statsShowStart();
+	// guard against showing too rapidly
+	statsFrameStart(waitForFrame());
 
 	// If we have a function for computing power, use it!
 	if(m_pPowerFunc) {
 		scale = (*m_pPowerFunc)(scale, m_nPowerData);
 	}
+	limitDither();
 
 	CLEDController *pCur = CLEDController::head();
 	while(pCur) {
-		uint8_t d = pCur->getDither();
-		if(m_nFPS < 100) { pCur->setDither(0); }
+#if FASTLED_SKIP_UNCHANGED == 1
+		pCur->invalidateFrame();
+#endif
+		STATS_FRAME(pCur);
 		pCur->showColor(color, scale);
-		pCur->setDither(d);
 		pCur = pCur->next();
 	}
 	countFPS();
+	statsShowEnd();
 }
 
 void CFastLED::clear(bool writeData) {
@@ -150,8 +577,8 @@ void CFastLED::delay(unsigned long ms) {
         do {
 #ifndef FASTLED_ACCURATE_CLOCK
 		// make sure to allow at least one ms to pass to ensure the clock moves
-		// forward
-		::delay(1);
+		// forward.  With a maximum refresh rate, show waits for that instead
+		if(!m_nMinMicros) { ::delay(1); }
 #endif
 		show();
 		yield();
@@ -244,6 +671,42 @@ void CFastLED::countFPS(int nFrames) {
 	}
 }
 
+#if FASTLED_STATS == 1
+void CFastLED::statsShowStart() {
+	m_nStatsStart = micros();
+}
+
+void CFastLED::statsFrameStart(uint32_t now) {
+	m_Stats.throttleMicros += now - m_nStatsStart;
+	++m_Stats.frames;
+	// no interval (or lateness) for the very first frame
+	if(m_nStatsLastFrame) {
+		if(m_nFrameSlack < 0) { ++m_Stats.lateFrames; }
+		uint32_t interval = now - m_nStatsLastFrame;
+		if(!m_Stats.intervals++ || interval < m_Stats.minFrameMicros) { m_Stats.minFrameMicros = interval; }
+		if(interval > m_Stats.maxFrameMicros) { m_Stats.maxFrameMicros = interval; }
+		m_Stats.totalFrameMicros += interval;
+		uint8_t bucket = 0;
+		for(uint32_t ms = interval / 1000; ms && bucket < (FASTLED_STATS_BUCKETS - 1); ms >>= 1) { ++bucket; }
+		++m_Stats.histogram[bucket];
+	}
+	m_nStatsLastFrame = now ? now : 1;
+}
+
+void CFastLED::statsShowEnd() {
+	m_Stats.showMicros += micros() - m_nStatsStart;
+}
+
+void CFastLED::resetStats() {
+	memset8((void*)&m_Stats, 0, sizeof(m_Stats));
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		pCur->resetStats();
+		pCur = pCur->next();
+	}
+}
+#endif
+
 void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
 	if(constrain) {
 		// if we're constraining, the new value of m_nMinMicros _must_ be higher than previously (because we're only
@@ -256,6 +719,35 @@ void CFastLED::setMaxRefreshRate(uint16_t refresh, bool constrain) {
 	} else {
 		m_nMinMicros = 0;
 	}
+
+#if WIRE_DEBUG_PRINT == 1
+	// check the rate that's now in effect, which constraining may have kept from an earlier call
+	uint32_t wireMicros = getWireMicros();
+	if(m_nMinMicros && (m_nMinMicros < wireMicros)) {
+		Serial.print("max refresh rate ");
+		Serial.print(1000000 / m_nMinMicros);
+		Serial.print("Hz is more than the wire allows, ");
+		Serial.print(getMaxWireFPS());
+		Serial.println("Hz");
+	}
+#endif
+}
+
+uint32_t CFastLED::getWireMicros() {
+	uint32_t total = 0;
+	CLEDController *pCur = CLEDController::head();
+	while(pCur) {
+		total += pCur->getFrameWireMicros();
+		pCur = pCur->next();
+	}
+	return total;
+}
+
+uint16_t CFastLED::getMaxWireFPS() {
+	uint32_t wireMicros = getWireMicros();
+	if(wireMicros == 0) { return 0; }
+	if(wireMicros < 16) { return 0xFFFF; }
+	return (wireMicros < 1000000) ? (1000000 / wireMicros) : 1;
 }
 
 extern "C" int atexit(void (* /*func*/ )()) { return 0; }
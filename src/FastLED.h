@@ -41,6 +41,7 @@
 
 #include "fastled_config.h"
 #include "led_sysdefs.h"
+#include "fastled_stats.h"
 
 // Utility functions
 #include "fastled_delay.h"
@@ -57,6 +58,7 @@
 #include "lib8tion.h"
 #include "pixeltypes.h"
 #include "hsv2rgb.h"
+#include "xymap.h"
 #include "colorutils.h"
 #include "pixelset.h"
 #include "colorpalettes.h"
@@ -174,6 +176,10 @@ enum EBlockChipsets {
 
 typedef uint8_t (*power_func)(uint8_t scale, uint32_t data);
 
+/// Called over and over while show waits for the next frame to be due (see setMaxRefreshRate), with the number of
+/// microseconds left to wait.  Anything it runs past that delays the frame.
+typedef void (*idle_func)(uint32_t slackMicros);
+
 /// High level controller interface for FastLED.  This class manages controllers, global settings and trackings
 /// such as brightness, and refresh rates, and provides access functions for driving led data to controllers
 /// via the show/showColor/clear methods.
@@ -185,6 +191,44 @@ class CFastLED {
 	uint32_t m_nMinMicros;		///< minimum µs between frames, used for capping frame rates.
 	uint32_t m_nPowerData;		///< max power use parameter
 	power_func m_pPowerFunc;	///< function for overriding brightness when using FastLED.show();
+	idle_func m_pIdleFunc;		///< called while waiting for the next frame, yield() is called instead when NULL
+	int32_t m_nFrameSlack;		///< µs the last frame was shown ahead of its deadline, negative if it was late
+	uint32_t m_nRenderMicros;	///< average time from waitToRender returning to the next show
+	uint32_t m_nRenderDev;		///< average difference of that time from m_nRenderMicros
+	uint32_t m_nRenderStart;	///< when waitToRender last returned, 0 if it hasn't since the last frame
+
+	uint32_t idleUntil(uint32_t deadline);
+	uint32_t waitForFrame();
+#if FASTLED_SKIP_UNCHANGED == 1
+	uint32_t m_nSkippedFrames;	///< controller frames not written out because nothing had changed
+	uint16_t m_nKeepAlive;		///< ms after which an unchanged controller is written out anyway, 0 for never
+
+	bool unchangedFrame(CLEDController *pLed, uint8_t scale);
+	void findUnchanged(uint8_t scale);
+	bool skipUnchanged(CLEDController *pLed) { return pLed->m_bSkipFrame; }
+#else
+	void findUnchanged(uint8_t) { }
+	bool skipUnchanged(CLEDController *) { return false; }
+#endif
+#if FASTLED_ADAPTIVE_DITHER == 1
+	void limitDither() { }
+#else
+	// under 100fps a dither cycle flickers visibly, so dithering is left out
+	void limitDither() { CLEDController::m_bDitherOff = (m_nFPS < 100); }
+#endif
+#if FASTLED_STATS == 1
+	CFastLEDStats m_Stats;			///< frame timing statistics
+	uint32_t m_nStatsStart;		///< when the show being timed started
+	uint32_t m_nStatsLastFrame;	///< when the last frame started, after any throttling (0 before the first frame)
+
+	void statsShowStart();
+	void statsFrameStart(uint32_t now);
+	void statsShowEnd();
+#else
+	void statsShowStart() {}
+	void statsFrameStart(uint32_t) {}
+	void statsShowEnd() {}
+#endif
 
 public:
 	CFastLED();
@@ -202,10 +246,13 @@ public:
 	/// @param nLedsIfOffset - number of leds (4 argument version)
 	/// @returns a reference to the added controller
 	static CLEDController &addLeds(CLEDController *pLed, struct CRGB *data, int nLedsOrOffset, int nLedsIfOffset = 0);
-	// with brightness data:
-	static CLEDController &addLeds(CLEDController *pLed, struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0); 
-	// with brightness data:
-	static CLEDController &addLeds(CLEDController *pLed, struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0); 
+	// with brightness data, either as a separate array or interleaved CRGB5b:
+	static CBrightnessLEDController &addLeds(CBrightnessLEDController *pLed, struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0);
+	static CBrightnessLEDController &addLeds(CBrightnessLEDController *pLed, struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0);
+	// brightness data can only go to a controller whose chipset has a brightness field - anything else is a
+	// compile error here rather than silently dropping the brightness
+	static CLEDController &addLeds(CLEDController *pLed, struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) = delete;
+	static CLEDController &addLeds(CLEDController *pLed, struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) = delete;
 
 	/// @name Adding SPI based controllers
   //@{
@@ -268,40 +315,34 @@ public:
 		}
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER, uint32_t SPI_DATA_RATE > CLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER, SPI_DATA_RATE> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER, uint32_t SPI_DATA_RATE > CBrightnessLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER, SPI_DATA_RATE> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset);
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN > static CLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102Controller<DATA_PIN, CLOCK_PIN> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN > static CBrightnessLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset);
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER > static CLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102Controller<DATA_PIN, CLOCK_PIN, RGB_ORDER> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER > static CBrightnessLEDController &addLeds(struct CRGB *data, uint8_t *bdata, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER> c; return addLeds(&c, data, bdata, nLedsOrOffset, nLedsIfOffset);
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER, uint32_t SPI_DATA_RATE > CLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER, SPI_DATA_RATE> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER, uint32_t SPI_DATA_RATE > CBrightnessLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER, SPI_DATA_RATE> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN > static CLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102Controller<DATA_PIN, CLOCK_PIN> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN > static CBrightnessLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
 	}
 
-	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER > static CLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
-		switch(CHIPSET) {
-			case APA102WB: { static APA102Controller<DATA_PIN, CLOCK_PIN, RGB_ORDER> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset); }
-		}
+	template<ESPIChipsets CHIPSET,  uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER > static CBrightnessLEDController &addLeds(struct CRGB5b *data, int nLedsOrOffset, int nLedsIfOffset = 0) {
+		static_assert(CHIPSET == APA102WB, "per pixel brightness data needs a chipset with a brightness field (APA102WB)");
+		static APA102WBController<DATA_PIN, CLOCK_PIN, RGB_ORDER> c; return addLeds(&c, data, nLedsOrOffset, nLedsIfOffset);
 	}
 
 
@@ -542,6 +583,20 @@ public:
 	/// Update all our controllers with the current led colors
 	void show() { show(m_Scale); }
 
+	/// Start updating all our controllers with the current led colors and return without waiting for the data to go
+	/// out, so the next frame can be rendered in the meantime.  Waits for the previous frame first.  Controllers that
+	/// can output in the background (see CLEDController::showLedsAsync) do so from their own buffers.  For the rest, the
+	/// led data is copied and written out from a worker on platforms that have one (the host), otherwise it is written
+	/// out before this returns, the same as show.
+	/// @param scale temporarily override the scale
+	void showAsync(uint8_t scale);
+
+	/// Start updating all our controllers with the current led colors, see showAsync(uint8_t)
+	void showAsync() { showAsync(m_Scale); }
+
+	/// Wait for the frame started by showAsync to finish going out.  show, showColor and showAsync do this themselves.
+	void waitShowComplete();
+
 	/// clear the leds, wiping the local array of data, optionally black out the leds as well
 	/// @param writeData whether or not to write out to the leds as well
 	void clear(bool writeData = false);
@@ -560,7 +615,8 @@ public:
 
 	/// Delay for the given number of milliseconds.  Provided to allow the library to be used on platforms
 	/// that don't have a delay function (to allow code to be more portable).  Note: this will call show
- 	/// constantly to drive the dithering engine (and will call show at least once).
+ 	/// constantly to drive the dithering engine (and will call show at least once).  With a maximum refresh rate
+	/// set, the time between frames goes to the idle hook (see setIdleHook).
 	/// @param ms the number of milliseconds to pause for
 	void delay(unsigned long ms);
 
@@ -576,14 +632,14 @@ public:
 
 	/// Set the dithering mode.  Sets the dithering mode for all added led strips, overriding
 	/// whatever previous dithering option those controllers may have had.
-	/// @param ditherMode - what type of dithering to use, either BINARY_DITHER or DISABLE_DITHER
+	/// @param ditherMode - what type of dithering to use: BINARY_DITHER, ERROR_DIFFUSION_DITHER or DISABLE_DITHER
 	void setDither(uint8_t ditherMode = BINARY_DITHER);
 
 	/// Set the maximum refresh rate.  This is global for all leds.  Attempts to
 	/// call show faster than this rate will simply wait.  Note that the refresh rate
 	/// defaults to the slowest refresh rate of all the leds added through addLeds.  If
 	/// you wish to set/override this rate, be sure to call setMaxRefreshRate _after_
-	/// adding all of your leds.
+	/// adding all of your leds.  getMaxWireFPS tells how fast the leds can actually be written out.
 	/// @param refresh - maximum refresh rate in hz
 	/// @param constrain - constrain refresh rate to the slowest speed yet set
 	void setMaxRefreshRate(uint16_t refresh, bool constrain=false);
@@ -598,6 +654,60 @@ public:
 	/// @returns the most recently computed FPS value
 	uint16_t getFPS() { return m_nFPS; }
 
+	/// Set the number of workers show spreads the controllers over, counting the calling thread.  Each worker encodes
+	/// and writes out whole show groups (see CLEDController::setShowGroup), and show returns once all of them are
+	/// done.  Only platforms with a show pool (the host) have workers, elsewhere show always runs on the calling thread.
+	/// @param nWorkers - the number of workers, 1 (the default) to show every controller on the calling thread
+	void setShowWorkers(int nWorkers);
+
+	/// Set a function for show to call while it waits for the next frame to be due, in place of yield().  Useful
+	/// for polling inputs or doing background work instead of spinning.
+	/// @param pFunc - the idle hook, see idle_func.  NULL (the default) goes back to calling yield()
+	void setIdleHook(idle_func pFunc) { m_pIdleFunc = pFunc; }
+
+	/// Get how early the last frame was.  Frames are due every 1/refresh seconds at the maximum refresh rate (see
+	/// setMaxRefreshRate), and show waits until they are.  A late frame is shown straight away, and the frames after it
+	/// are due a whole frame time later.
+	/// @returns the µs show waited for the frame to be due, or minus how late it was.  0 with no maximum refresh rate
+	int32_t getFrameSlack() { return m_nFrameSlack; }
+
+	/// Wait until the latest time the next frame can be rendered and still be shown when it's due, calling the idle
+	/// hook meanwhile.  Call this right before reading inputs and rendering a frame, then call show: the leds then
+	/// show the most recent input possible.  The time rendering takes is learned from the frames before.  Without a
+	/// maximum refresh rate this returns straight away.
+	void waitToRender();
+
+	/// Get the time, in microseconds, that a frame of all the leds added so far takes on the wire.  This is the total
+	/// of each controller's CLEDController::getFrameWireMicros, as show writes them out one after the other (outputs
+	/// that send several controllers at once, like the ESP32 RMT and I2S drivers, take less).
+	uint32_t getWireMicros();
+
+	/// Get the highest frame rate the wire allows for the leds added so far (see getWireMicros).  show can't write
+	/// frames out any faster, whatever setMaxRefreshRate asks for; build with WIRE_DEBUG_PRINT defined to 1 to be
+	/// warned over Serial when it asks for more.
+	/// @returns frames per second, or 0 if none of the controllers know their wire time
+	uint16_t getMaxWireFPS();
+
+#if FASTLED_SKIP_UNCHANGED == 1
+	/// Set how often controllers whose data hasn't changed get written out anyway, for leds that need refreshing
+	/// or to recover from glitches on the wire.
+	/// @param ms - milliseconds between forced refreshes, 0 (the default) to never force them
+	void setKeepAlive(uint16_t ms) { m_nKeepAlive = ms; }
+
+	/// Get the number of times show skipped writing out a controller because its frame hadn't changed
+	/// @returns the number of skipped controller frames since startup
+	uint32_t getSkippedFrames() { return m_nSkippedFrames; }
+#endif
+
+#if FASTLED_STATS == 1
+	/// Get the frame timing statistics for show, showColor and showAsync (see fastled_stats.h).  Each controller's
+	/// own statistics are available from CLEDController::getStats.
+	const CFastLEDStats & getStats() { return m_Stats; }
+
+	/// Zero the frame timing statistics, along with those of every controller
+	void resetStats();
+#endif
+
 	/// Get how many controllers have been registered
 	/// @returns the number of controllers (strips) that have been added with addLeds
 	int count();
@@ -4,6 +4,10 @@
 #include "FastLED.h"
 #include "pixeltypes.h"
 
+#if FASTLED_APA102_FRAME_BUFFER == 1
+#include <stdlib.h>
+#endif
+
 ///@file chipsets.h
 /// contains the bulk of the definitions for the various LED chipsets supported.
 
@@ -32,6 +36,9 @@ class PixieController : public CPixelLEDController<RGB_ORDER> {
 public:
 	PixieController() : Serial(-1, DATA_PIN) {}
 
+	// 3 bytes per led at 115200 baud (10 bits a byte), then the 2ms latch
+	virtual uint32_t getWireMicros(int nLeds) const { return ((uint32_t)nLeds * 3125) / 12 + 2000; }
+
 protected:
 	virtual void init() {
 		Serial.begin(115200);
@@ -100,6 +107,8 @@ public:
 		mSPI.init();
 	}
 
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * (nLeds * 3 + ((nLeds * 3 + 63) >> 6))); }
+
 protected:
 
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
@@ -133,6 +142,8 @@ public:
 	  mWaitDelay.mark();
 	}
 
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * 3 * nLeds) + 1000; }
+
 protected:
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 		mWaitDelay.wait();
@@ -166,6 +177,8 @@ public:
 		mSPI.init();
 	}
 
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * (4 + 2 * nLeds)); }
+
 protected:
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 		mSPI.select();
@@ -196,18 +209,21 @@ protected:
 //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// APA102 controller class.
-/// @tparam DATA_PIN the data pin for these leds
-/// @tparam CLOCK_PIN the clock pin for these leds
-/// @tparam RGB_ORDER the RGB ordering for these leds
-/// @tparam SPI_SPEED the clock divider used for these leds.  Set using the DATA_RATE_MHZ/DATA_RATE_KHZ macros.  Defaults to DATA_RATE_MHZ(12)
-template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER = RGB, uint32_t SPI_SPEED = DATA_RATE_MHZ(12)>
-class APA102Controller : public CPixelLEDController<RGB_ORDER> {
-	typedef SPIOutput<DATA_PIN, CLOCK_PIN, SPI_SPEED> SPI;
-	SPI mSPI;
+/// Bytes in an APA102 family frame of nLeds leds: the start frame, 4 bytes per led and the end frame
+inline int apa102FrameSize(int nLeds) { return 4 + (4 * nLeds) + (4 * ((nLeds/32) + 1)); }
+
+/// Wire format output for the APA102 family that writes each led straight out over SPI.  The caller
+/// handles select/release around the frame.
+/// @tparam SPI the spi output class to write to
+template <class SPI>
+class APA102SPIWriter {
+	SPI & mSPI;
+
+public:
+	APA102SPIWriter(SPI & spi) : mSPI(spi) {}
 
 	void startBoundary() { mSPI.writeWord(0); mSPI.writeWord(0); }
-	void endBoundary(int nLeds) { int nDWords = (nLeds/32); do { mSPI.writeByte(0xFF); mSPI.writeByte(0x00); mSPI.writeByte(0x00); mSPI.writeByte(0x00); } while(nDWords--); }
+	void endBoundary(int nLeds, uint8_t endByte) { int nDWords = (nLeds/32); do { mSPI.writeByte(endByte); mSPI.writeByte(0x00); mSPI.writeByte(0x00); mSPI.writeByte(0x00); } while(nDWords--); }
 
 	inline void writeLed(uint8_t brightness, uint8_t b0, uint8_t b1, uint8_t b2) __attribute__((always_inline)) {
 #ifdef FASTLED_SPI_BYTE_ONLY
@@ -223,18 +239,77 @@ class APA102Controller : public CPixelLEDController<RGB_ORDER> {
 		mSPI.writeWord(w);
 #endif
 	}
+};
+
+#if FASTLED_APA102_FRAME_BUFFER == 1
+/// Wire format output for the APA102 family that encodes a whole frame (start frame, leds and end frame) into
+/// a contiguous buffer, so it can go out with a single writeBytes call.  The buffer grows to fit the largest
+/// frame seen and is kept between frames.
+class CAPA102FrameBuffer {
+	uint8_t *mData;
+	uint8_t *mPos;
+	int mCapacity;
+#if FASTLED_STATS == 1
+	uint32_t mStart;
+#endif
 
 public:
-	APA102Controller() {}
+	CAPA102FrameBuffer() : mData(NULL), mPos(NULL), mCapacity(0) {}
+	~CAPA102FrameBuffer() { free(mData); }
+
+	/// Number of bytes in a frame of nLeds leds
+	static int frameSize(int nLeds) { return apa102FrameSize(nLeds); }
+
+	/// Make room for a frame of nLeds leds and rewind.  Returns false if the buffer couldn't be allocated.
+	bool begin(int nLeds) {
+		int nBytes = frameSize(nLeds);
+		if(nBytes > mCapacity) {
+			uint8_t *pData = (uint8_t*)realloc(mData, nBytes);
+			if(pData == NULL) { return false; }
+			mData = pData;
+			mCapacity = nBytes;
+		}
+		mPos = mData;
+#if FASTLED_STATS == 1
+		mStart = micros();
+#endif
+		return true;
+	}
 
-	virtual void init() {
-		mSPI.init();
+	void startBoundary() { mPos[0] = 0; mPos[1] = 0; mPos[2] = 0; mPos[3] = 0; mPos += 4; }
+	void endBoundary(int nLeds, uint8_t endByte) {
+		int nDWords = (nLeds/32); do { mPos[0] = endByte; mPos[1] = 0; mPos[2] = 0; mPos[3] = 0; mPos += 4; } while(nDWords--);
+		// the frame is encoded, the rest is transmitting it
+		FASTLED_STAT_ADD(encodeMicros, micros() - mStart);
 	}
 
-protected:
-	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
-		mSPI.select();
+	inline void writeLed(uint8_t brightness, uint8_t b0, uint8_t b1, uint8_t b2) __attribute__((always_inline)) {
+		mPos[0] = 0xE0 | brightness;
+		mPos[1] = b0;
+		mPos[2] = b1;
+		mPos[3] = b2;
+		mPos += 4;
+	}
 
+	uint8_t *data() { return mData; }
+	int size() const { return mPos - mData; }
+};
+#endif
+
+/// APA102 controller class.
+/// @tparam DATA_PIN the data pin for these leds
+/// @tparam CLOCK_PIN the clock pin for these leds
+/// @tparam RGB_ORDER the RGB ordering for these leds
+/// @tparam SPI_SPEED the clock divider used for these leds.  Set using the DATA_RATE_MHZ/DATA_RATE_KHZ macros.  Defaults to DATA_RATE_MHZ(12)
+template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER = RGB, uint32_t SPI_SPEED = DATA_RATE_MHZ(12)>
+class APA102Controller : public CPixelLEDController<RGB_ORDER> {
+	typedef SPIOutput<DATA_PIN, CLOCK_PIN, SPI_SPEED> SPI;
+	SPI mSPI;
+#if FASTLED_APA102_FRAME_BUFFER == 1
+	CAPA102FrameBuffer mFrame;
+#endif
+
+	template <class OUT> void writeFrame(OUT & out, PixelController<RGB_ORDER> & pixels) {
 		uint8_t s0 = pixels.getScale0(), s1 = pixels.getScale1(), s2 = pixels.getScale2();
 #if FASTLED_USE_GLOBAL_BRIGHTNESS == 1
 		const uint16_t maxBrightness = 0x1F;
@@ -246,14 +321,36 @@ protected:
 		const uint8_t brightness = 0x1F;
 #endif
 
-		startBoundary();
+		out.startBoundary();
 		while (pixels.has(1)) {
-			writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
+			out.writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
 			pixels.stepDithering();
 			pixels.advanceData();
 		}
-		endBoundary(pixels.size());
+		out.endBoundary(pixels.size(), 0xFF);
+	}
 
+public:
+	APA102Controller() {}
+
+	virtual void init() {
+		mSPI.init();
+	}
+
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * apa102FrameSize(nLeds)); }
+
+protected:
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+#if FASTLED_APA102_FRAME_BUFFER == 1
+		if(mFrame.begin(pixels.size())) {
+			writeFrame(mFrame, pixels);
+			mSPI.writeBytes(mFrame.data(), mFrame.size());
+			return;
+		}
+#endif
+		APA102SPIWriter<SPI> out(mSPI);
+		mSPI.select();
+		writeFrame(out, pixels);
 		mSPI.waitFully();
 		mSPI.release();
 	}
@@ -266,71 +363,62 @@ protected:
 /// @tparam RGB_ORDER the RGB ordering for these leds
 /// @tparam SPI_SPEED the clock divider used for these leds.  Set using the DATA_RATE_MHZ/DATA_RATE_KHZ macros.  Defaults to DATA_RATE_MHZ(12)
 template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER = RGB, uint32_t SPI_SPEED = DATA_RATE_MHZ(12)>
-class APA102WBController : public CPixelLEDController<RGB_ORDER> {
+class APA102WBController : public CPixelBrightnessLEDController<RGB_ORDER> {
 	typedef SPIOutput<DATA_PIN, CLOCK_PIN, SPI_SPEED> SPI;
 	SPI mSPI;
-
-	void startBoundary() { mSPI.writeWord(0); mSPI.writeWord(0); }
-	void endBoundary(int nLeds) { int nDWords = (nLeds/32); do { mSPI.writeByte(0xFF); mSPI.writeByte(0x00); mSPI.writeByte(0x00); mSPI.writeByte(0x00); } while(nDWords--); }
-
-	inline void writeLed(uint8_t brightness, uint8_t b0, uint8_t b1, uint8_t b2) __attribute__((always_inline)) {
-#ifdef FASTLED_SPI_BYTE_ONLY
-		mSPI.writeByte(0xE0 | brightness);
-		mSPI.writeByte(b0);
-		mSPI.writeByte(b1);
-		mSPI.writeByte(b2);
-#else
-		uint16_t b = 0xE000 | (brightness << 8) | (uint16_t)b0;
-		mSPI.writeWord(b);
-		uint16_t w = b1 << 8;
-		w |= b2;
-		mSPI.writeWord(w);
+#if FASTLED_APA102_FRAME_BUFFER == 1
+	CAPA102FrameBuffer mFrame;
 #endif
-	}
-
-public:
-	APA102WBController() {}
-
-	virtual void init() {
-		mSPI.init();
-	}
-
-protected:
-	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
-		mSPI.select();
 
+	template <class OUT, EPixelFormat FORMAT> void writeFrame(OUT & out, PixelController<RGB_ORDER, 1, 0xFFFFFFFF, FORMAT> & pixels) {
 		uint8_t s0 = pixels.getScale0(), s1 = pixels.getScale1(), s2 = pixels.getScale2();
-		// uint8_t s3 = 0xff; // don't scale 5bit brightness value
 #if FASTLED_USE_GLOBAL_BRIGHTNESS == 1
 		const uint16_t maxBrightness = 0x1F;
 		uint16_t brightness = ((((uint16_t)max(max(s0, s1), s2) + 1) * maxBrightness - 1) >> 8) + 1;
 		s0 = (maxBrightness * s0 + (brightness >> 1)) / brightness;
 		s1 = (maxBrightness * s1 + (brightness >> 1)) / brightness;
 		s2 = (maxBrightness * s2 + (brightness >> 1)) / brightness;
-#else
-		// const uint8_t brightness = 0x1F;
 #endif
 
-		startBoundary();
+		// the per pixel brightness comes from the data (full brightness for plain CRGB, e.g. showColor)
+		out.startBoundary();
 		while (pixels.has(1)) {
-			// include brightness val - nlg
-			// works with mData + bData - TODO gracefully select between the two:
-			writeLed(pixels.get5bitBright(), pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
-			
-			// works with mbData???  Not yet :( - nlg
-			// writeLed(pixels.loadAndScaleWB3(0, s3), pixels.loadAndScaleWB0(0, s0), pixels.loadAndScaleWB1(0, s1), pixels.loadAndScaleWB2(0, s2));
-			// writeLed(pixels.loadWB3(0, s3), pixels.loadWB0(0, s0), pixels.loadWB1(0, s1), pixels.loadWB2(0, s2));
-
-			// writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
+			out.writeLed(pixels.loadBrightness(), pixels.loadDitherAndScale0(0, s0), pixels.loadDitherAndScale1(0, s1), pixels.loadDitherAndScale2(0, s2));
 			pixels.stepDithering();
 			pixels.advanceData();
 		}
-		endBoundary(pixels.size());
+		out.endBoundary(pixels.size(), 0xFF);
+	}
 
+	template <EPixelFormat FORMAT> void showFrame(PixelController<RGB_ORDER, 1, 0xFFFFFFFF, FORMAT> & pixels) {
+#if FASTLED_APA102_FRAME_BUFFER == 1
+		if(mFrame.begin(pixels.size())) {
+			writeFrame(mFrame, pixels);
+			mSPI.writeBytes(mFrame.data(), mFrame.size());
+			return;
+		}
+#endif
+		APA102SPIWriter<SPI> out(mSPI);
+		mSPI.select();
+		writeFrame(out, pixels);
 		mSPI.waitFully();
 		mSPI.release();
 	}
 
+public:
+	APA102WBController() {}
+
+	virtual void init() {
+		mSPI.init();
+	}
+
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * apa102FrameSize(nLeds)); }
+
+protected:
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) { showFrame(pixels); }
+	virtual void showPixels(PixelController<RGB_ORDER, 1, 0xFFFFFFFF, PIXEL_RGB8_BRT> & pixels) { showFrame(pixels); }
+	virtual void showPixels(PixelController<RGB_ORDER, 1, 0xFFFFFFFF, PIXEL_RGB5B> & pixels) { showFrame(pixels); }
+
 };
 
 /// SK9822 controller class.
@@ -342,36 +430,11 @@ template <uint8_t DATA_PIN, uint8_t CLOCK_PIN, EOrder RGB_ORDER = RGB, uint32_t
 class SK9822Controller : public CPixelLEDController<RGB_ORDER> {
 	typedef SPIOutput<DATA_PIN, CLOCK_PIN, SPI_SPEED> SPI;
 	SPI mSPI;
-
-	void startBoundary() { mSPI.writeWord(0); mSPI.writeWord(0); }
-	void endBoundary(int nLeds) { int nLongWords = (nLeds/32); do { mSPI.writeByte(0x00); mSPI.writeByte(0x00); mSPI.writeByte(0x00); mSPI.writeByte(0x00); } while(nLongWords--); }
-
-	inline void writeLed(uint8_t brightness, uint8_t b0, uint8_t b1, uint8_t b2) __attribute__((always_inline)) {
-#ifdef FASTLED_SPI_BYTE_ONLY
-		mSPI.writeByte(0xE0 | brightness);
-		mSPI.writeByte(b0);
-		mSPI.writeByte(b1);
-		mSPI.writeByte(b2);
-#else
-		uint16_t b = 0xE000 | (brightness << 8) | (uint16_t)b0;
-		mSPI.writeWord(b);
-		uint16_t w = b1 << 8;
-		w |= b2;
-		mSPI.writeWord(w);
+#if FASTLED_APA102_FRAME_BUFFER == 1
+	CAPA102FrameBuffer mFrame;
 #endif
-	}
-
-public:
-	SK9822Controller() {}
-
-	virtual void init() {
-		mSPI.init();
-	}
-
-protected:
-	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
-		mSPI.select();
 
+	template <class OUT> void writeFrame(OUT & out, PixelController<RGB_ORDER> & pixels) {
 		uint8_t s0 = pixels.getScale0(), s1 = pixels.getScale1(), s2 = pixels.getScale2();
 #if FASTLED_USE_GLOBAL_BRIGHTNESS == 1
 		const uint16_t maxBrightness = 0x1F;
@@ -383,15 +446,38 @@ protected:
 		const uint8_t brightness = 0x1F;
 #endif
 
-		startBoundary();
+		out.startBoundary();
 		while (pixels.has(1)) {
-			writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
+			out.writeLed(brightness, pixels.loadAndScale0(0, s0), pixels.loadAndScale1(0, s1), pixels.loadAndScale2(0, s2));
 			pixels.stepDithering();
 			pixels.advanceData();
 		}
 
-		endBoundary(pixels.size());
+		// SK9822 wants zeros in the end frame
+		out.endBoundary(pixels.size(), 0x00);
+	}
+
+public:
+	SK9822Controller() {}
+
+	virtual void init() {
+		mSPI.init();
+	}
+
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * apa102FrameSize(nLeds)); }
 
+protected:
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+#if FASTLED_APA102_FRAME_BUFFER == 1
+		if(mFrame.begin(pixels.size())) {
+			writeFrame(mFrame, pixels);
+			mSPI.writeBytes(mFrame.data(), mFrame.size());
+			return;
+		}
+#endif
+		APA102SPIWriter<SPI> out(mSPI);
+		mSPI.select();
+		writeFrame(out, pixels);
 		mSPI.waitFully();
 		mSPI.release();
 	}
@@ -430,6 +516,8 @@ public:
 		mSPI.init();
 	}
 
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 8 * (4 + 4 * nLeds + 4)); }
+
 protected:
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 		mSPI.select();
@@ -487,6 +575,9 @@ public:
 		mSPI.init();
 	}
 
+	// 25 bits per led (a start bit and the rgb data), then the 50 bit header
+	virtual uint32_t getWireMicros(int nLeds) const { return SPI_WIRE_MICROS(SPI_SPEED, 25 * nLeds + 50); }
+
 protected:
 	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
 		// Make sure the FLAG_START_BIT flag is set to ensure that an extra 1 bit is sent at the start
@@ -519,12 +610,6 @@ protected:
 /// Provides timing definitions for the variety of clockless controllers supplied by the library.
 /// @{
 
-// Allow clock that clockless controller is based on to have different
-// frequency than the CPU.
-#if !defined(CLOCKLESS_FREQUENCY)
-    #define CLOCKLESS_FREQUENCY F_CPU
-#endif
-
 // We want to force all avr's to use the Trinket controller when running at 8Mhz, because even the 328's at 8Mhz
 // need the more tightly defined timeframes.
 #if defined(__LGT8F__) || (CLOCKLESS_FREQUENCY == 8000000 || CLOCKLESS_FREQUENCY == 16000000 || CLOCKLESS_FREQUENCY == 24000000) //  || CLOCKLESS_FREQUENCY == 48000000 || CLOCKLESS_FREQUENCY == 96000000) // 125ns/clock
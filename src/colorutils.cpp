@@ -2,6 +2,7 @@
 #define __PROG_TYPES_COMPAT__
 
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 #include "FastLED.h"
@@ -41,10 +42,23 @@ void fill_rainbow( struct CRGB * pFirstLED, int numToFill,
     hsv.hue = initialhue;
     hsv.val = 255;
     hsv.sat = 240;
+#if defined(__AVR__)
     for( int i = 0; i < numToFill; ++i) {
         pFirstLED[i] = hsv;
         hsv.hue += deltahue;
     }
+#else
+    // a few at a time, so that the batch hsv2rgb_rainbow can convert them side by side
+    CHSV hsvs[16];
+    for( int i = 0; i < numToFill; i += 16) {
+        int n = (numToFill - i < 16) ? (numToFill - i) : 16;
+        for( int j = 0; j < n; ++j) {
+            hsvs[j] = hsv;
+            hsv.hue += deltahue;
+        }
+        hsv2rgb_rainbow( hsvs, pFirstLED + i, n);
+    }
+#endif
 }
 
 void fill_rainbow( struct CHSV * targetArray, int numToFill,
@@ -210,11 +224,147 @@ void fill_gradient_RGB( CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB
 
 
 
+#if !defined(__AVR__)
+
+// Bulk kernels for the array versions of nscale8, nscale8_video, fadeUsingColor, nblend and blend.  Led data is
+// worked on as a plain run of bytes, a word at a time, with two bytes to each 16 bit lane: the even bytes in the
+// low halves of the lanes, and the odd bytes, shifted down, in the high halves.  A byte times a scale of up to 256
+// fits in a lane, so one multiply scales every byte in half a word.  W is a uint32_t, or on chips with SIMD a
+// vector of uint16_t lanes.  The results match scale8, scale8_video and blend8 exactly.
+#if defined(__AVX2__)
+#define COLORUTILS_VECTOR_BYTES 32
+#elif defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define COLORUTILS_VECTOR_BYTES 16
+#endif
+
+// v in every 16 bit lane
+template<class W> static inline W lanes( uint16_t v);
+template<> inline uint32_t lanes<uint32_t>( uint16_t v) { return v * (uint32_t)0x00010001; }
+
+#if defined(COLORUTILS_VECTOR_BYTES)
+typedef uint16_t byte_pairs_t __attribute__((vector_size(COLORUTILS_VECTOR_BYTES)));
+template<> inline byte_pairs_t lanes<byte_pairs_t>( uint16_t v) { return byte_pairs_t() + v; }
+#endif
+
+// (x * k) >> 8 for every byte x, with the even bytes scaled by ke and the odd bytes by ko (each up to 256)
+template<class W, class K> static inline W scaleBytes( W w, K ke, K ko)
+{
+    W lo = lanes<W>( 0x00FF);
+    return ((((w & lo) * ke) >> 8) & lo) | ((((w >> 8) & lo) * ko) & ~lo);
+}
+
+// (a * ka + b * kb) >> 8 for every pair of bytes a and b, where ka + kb is at most 257
+template<class W> static inline W mixBytes( W a, uint16_t ka, W b, uint16_t kb)
+{
+    W lo = lanes<W>( 0x00FF);
+    return ((((a & lo) * ka + (b & lo) * kb) >> 8) & lo) | ((((a >> 8) & lo) * ka + ((b >> 8) & lo) * kb) & ~lo);
+}
+
+// 1 in every byte that isn't 0
+template<class W> static inline W nonzeroBytes( W w)
+{
+    W low7 = lanes<W>( 0x7F7F);
+    return ((((w & low7) + low7) | w) >> 7) & lanes<W>( 0x0101);
+}
+
+struct ScaleBytes {
+    uint16_t k;
+    ScaleBytes( uint8_t scale) : k( scale + (FASTLED_SCALE8_FIXED == 1)) {}
+    template<class W> W operator()( W a, W, W) const { return scaleBytes( a, k, k); }
+};
+
+struct ScaleBytesVideo {
+    uint8_t scale;
+    ScaleBytesVideo( uint8_t s) : scale( s) {}
+    // scale8_video: scale8, plus 1 if both x and scale are non-zero.  The scaled byte is at most 254, so the
+    // 1 never carries into the next one.
+    template<class W> W operator()( W a, W, W) const {
+        return scaleBytes( a, scale, scale) + (nonzeroBytes( a) & lanes<W>( scale ? 0x0101 : 0));
+    }
+};
+
+// blend8( a, b, amountOfB) of every pair of bytes
+struct BlendBytes {
+    uint16_t ka, kb;
+    BlendBytes( fract8 amountOfB)
+        : ka( 255 - amountOfB + (FASTLED_SCALE8_FIXED == 1)), kb( amountOfB + (FASTLED_SCALE8_FIXED == 1)) {}
+#if (FASTLED_BLEND_FIXED == 1)
+    template<class W> W operator()( W a, W b, W) const { return mixBytes( a, ka, b, kb); }
+#else
+    // the two scaled bytes never add up to more than 255, so no carries cross between them
+    template<class W> W operator()( W a, W b, W) const { return scaleBytes( a, ka, ka) + scaleBytes( b, kb, kb); }
+#endif
+};
+
+// min( x, 255) in every 16 bit lane
+template<class W> static inline W saturateLanes( W x)
+{
+    W lo = lanes<W>( 0x00FF);
+    W over = ((((x >> 8) & lo) + lo) >> 8) & lanes<W>( 1);
+    return (x | (over * 0xFF)) & lo;
+}
+
+// qadd8( qadd8( scale8( x, keep), a), b) of every byte x, with a and b the matching bytes of two other runs.  As
+// all three are positive, the sum can be saturated once, at the end.
+struct BlurBytes {
+    uint16_t k;
+    BlurBytes( uint8_t keep) : k( keep + (FASTLED_SCALE8_FIXED == 1)) {}
+    template<class W> W operator()( W x, W a, W b) const {
+        W lo = lanes<W>( 0x00FF);
+        W e = ((((x & lo) * k) >> 8) & lo) + (a & lo) + (b & lo);
+        W o = (((((x >> 8) & lo) * k) >> 8) & lo) + ((a >> 8) & lo) + ((b >> 8) & lo);
+        return saturateLanes( e) | (saturateLanes( o) << 8);
+    }
+};
+
+// dst[i] = op( a[i], b[i], c[i]) for nBytes bytes, a vector or a word at a time.  dst may be any of a, b or c.
+// Ops that take fewer inputs ignore the rest, and callers pass one of the others again for them.
+template<class OP> static void eachByte( uint8_t* dst, const uint8_t* a, const uint8_t* b, const uint8_t* c, uint32_t nBytes, OP op)
+{
+    uint8_t* end = dst + nBytes;
+#if defined(COLORUTILS_VECTOR_BYTES)
+    for( ; end - dst >= COLORUTILS_VECTOR_BYTES; dst += COLORUTILS_VECTOR_BYTES, a += COLORUTILS_VECTOR_BYTES, b += COLORUTILS_VECTOR_BYTES, c += COLORUTILS_VECTOR_BYTES) {
+        byte_pairs_t wa, wb, wc;
+        memcpy( &wa, a, sizeof(wa));
+        memcpy( &wb, b, sizeof(wb));
+        memcpy( &wc, c, sizeof(wc));
+        wa = op( wa, wb, wc);
+        memcpy( dst, &wa, sizeof(wa));
+    }
+#else
+    // a byte at a time up to a word boundary, so that the word stores below are aligned
+    for( ; ((uintptr_t)dst & 3) && dst != end; ++dst, ++a, ++b, ++c) {
+        *dst = op( (uint32_t)*a, (uint32_t)*b, (uint32_t)*c);
+    }
+#endif
+    for( ; end - dst >= 4; dst += 4, a += 4, b += 4, c += 4) {
+        uint32_t wa, wb, wc;
+        memcpy( &wa, a, 4);
+        memcpy( &wb, b, 4);
+        memcpy( &wc, c, 4);
+        wa = op( wa, wb, wc);
+#if defined(COLORUTILS_VECTOR_BYTES)
+        memcpy( dst, &wa, 4);
+#else
+        memcpy( __builtin_assume_aligned( dst, 4), &wa, 4);
+#endif
+    }
+    for( ; dst != end; ++dst, ++a, ++b, ++c) {
+        *dst = op( (uint32_t)*a, (uint32_t)*b, (uint32_t)*c);
+    }
+}
+
+#endif
+
 void nscale8_video( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if defined(__AVR__)
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8_video( scale);
     }
+#else
+    eachByte( leds->raw, leds->raw, leds->raw, leds->raw, num_leds * 3UL, ScaleBytesVideo( scale));
+#endif
 }
 
 void fade_video(CRGB* leds, uint16_t num_leds, uint8_t fadeBy)
@@ -245,9 +395,13 @@ void nscale8_raw( CRGB* leds, uint16_t num_leds, uint8_t scale)
 
 void nscale8( CRGB* leds, uint16_t num_leds, uint8_t scale)
 {
+#if defined(__AVR__)
     for( uint16_t i = 0; i < num_leds; ++i) {
         leds[i].nscale8( scale);
     }
+#else
+    eachByte( leds->raw, leds->raw, leds->raw, leds->raw, num_leds * 3UL, ScaleBytes( scale));
+#endif
 }
 
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
@@ -257,7 +411,33 @@ void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
     fg = colormask.g;
     fb = colormask.b;
 
-    for( uint16_t i = 0; i < numLeds; ++i) {
+    uint16_t i = 0;
+#if defined(COLORUTILS_VECTOR_BYTES)
+    // COLORUTILS_VECTOR_BYTES leds at a time, as three vectors, each with its own pattern of channel scales
+    uint8_t pattern[3 * COLORUTILS_VECTOR_BYTES];
+    for( int j = 0; j < 3 * COLORUTILS_VECTOR_BYTES; j += 3) {
+        pattern[j] = fr;
+        pattern[j + 1] = fg;
+        pattern[j + 2] = fb;
+    }
+    byte_pairs_t ke[3], ko[3];
+    for( int j = 0; j < 3; ++j) {
+        byte_pairs_t w;
+        memcpy( &w, pattern + (j * COLORUTILS_VECTOR_BYTES), sizeof(w));
+        ke[j] = (w & 0xFF) + (FASTLED_SCALE8_FIXED == 1);
+        ko[j] = (w >> 8) + (FASTLED_SCALE8_FIXED == 1);
+    }
+    for( ; numLeds - i >= COLORUTILS_VECTOR_BYTES; i += COLORUTILS_VECTOR_BYTES) {
+        uint8_t* p = leds[i].raw;
+        for( int j = 0; j < 3; ++j, p += COLORUTILS_VECTOR_BYTES) {
+            byte_pairs_t w;
+            memcpy( &w, p, sizeof(w));
+            w = scaleBytes( w, ke[j], ko[j]);
+            memcpy( p, &w, sizeof(w));
+        }
+    }
+#endif
+    for( ; i < numLeds; ++i) {
         leds[i].r = scale8_LEAVING_R1_DIRTY( leds[i].r, fr);
         leds[i].g = scale8_LEAVING_R1_DIRTY( leds[i].g, fg);
         leds[i].b = scale8                 ( leds[i].b, fb);
@@ -265,6 +445,67 @@ void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask)
 }
 
 
+// 1/brt in 13.19 fixed point, pre-multiplied by 255*31/65535, so that an
+// 8 bit channel at brightness brt is (v16 * hdr5bRecip[brt]) >> 19
+static const uint16_t hdr5bRecip[32] FL_PROGMEM = {
+        0, 63241, 31620, 21080, 15810, 12648, 10540,  9034,
+     7905,  7027,  6324,  5749,  5270,  4865,  4517,  4216,
+     3953,  3720,  3513,  3328,  3162,  3011,  2875,  2750,
+     2635,  2530,  2432,  2342,  2259,  2181,  2108,  2040
+};
+
+// On 64 bit hosts red and blue share one multiply: both products are
+// under 2^28, so they can't carry out of their 32 bit halves.
+#if !defined(FASTLED_HDR_SWAR) && defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ >= 8)
+#define FASTLED_HDR_SWAR 1
+#endif
+
+static inline uint8_t hdr5bBrightness( const CRGB16& hdr)
+{
+    uint16_t top = hdr.r;
+    if( hdr.g > top) top = hdr.g;
+    if( hdr.b > top) top = hdr.b;
+
+    // ceil(top * 31 / 65535), using x / 65535 == (x + (x >> 16) + 1) >> 16
+    uint32_t x = ((uint32_t)top * 31) + 65534;
+    return (x + (x >> 16) + 1) >> 16;
+}
+
+static inline uint8_t hdr5bChannel( uint32_t scaled)
+{
+    scaled = (scaled + (1UL << 18)) >> 19;
+    return scaled > 255 ? 255 : scaled;
+}
+
+CRGB5b hdr16to5b( const CRGB16& hdr)
+{
+    uint8_t brt = hdr5bBrightness( hdr);
+    uint32_t recip = FL_PGM_READ_WORD_NEAR( hdr5bRecip + brt);
+    return CRGB5b( hdr5bChannel( hdr.r * recip),
+                   hdr5bChannel( hdr.g * recip),
+                   hdr5bChannel( hdr.b * recip),
+                   brt);
+}
+
+void hdr16to5b( const CRGB16* src, CRGB5b* dest, uint16_t numLeds)
+{
+    for( uint16_t i = 0; i < numLeds; ++i) {
+#if FASTLED_HDR_SWAR == 1
+        const CRGB16& hdr = src[i];
+        uint8_t brt = hdr5bBrightness( hdr);
+        uint64_t recip = FL_PGM_READ_WORD_NEAR( hdr5bRecip + brt);
+        uint64_t rb = ((uint64_t)hdr.b << 32) | hdr.r;
+        rb = (rb * recip) + ((1ULL << 50) | (1ULL << 18));
+        uint32_t r = (rb >> 19) & 0x1FFF;
+        uint32_t b = (rb >> 51) & 0x1FFF;
+        uint32_t g = hdr5bChannel( hdr.g * (uint32_t)recip);
+        dest[i].setRGB5b( r > 255 ? 255 : r, g, b > 255 ? 255 : b, brt);
+#else
+        dest[i] = hdr16to5b( src[i]);
+#endif
+    }
+}
+
 CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay )
 {
     if( amountOfOverlay == 0) {
@@ -302,11 +543,22 @@ CRGB& nblend( CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay )
 
 void nblend( CRGB* existing, CRGB* overlay, uint16_t count, fract8 amountOfOverlay)
 {
+#if defined(__AVR__)
     for( uint16_t i = count; i; --i) {
         nblend( *existing, *overlay, amountOfOverlay);
         ++existing;
         ++overlay;
     }
+#else
+    if( amountOfOverlay == 0) {
+        return;
+    }
+    if( amountOfOverlay == 255) {
+        memmove( (void*)existing, overlay, count * sizeof(CRGB));
+        return;
+    }
+    eachByte( existing->raw, existing->raw, overlay->raw, overlay->raw, count * 3UL, BlendBytes( amountOfOverlay));
+#endif
 }
 
 CRGB blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 )
@@ -318,9 +570,17 @@ CRGB blend( const CRGB& p1, const CRGB& p2, fract8 amountOfP2 )
 
 CRGB* blend( const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fract8 amountOfsrc2 )
 {
+#if defined(__AVR__)
     for( uint16_t i = 0; i < count; ++i) {
         dest[i] = blend(src1[i], src2[i], amountOfsrc2);
     }
+#else
+    if( amountOfsrc2 == 0 || amountOfsrc2 == 255) {
+        memmove( (void*)dest, amountOfsrc2 ? src2 : src1, count * sizeof(CRGB));
+    } else {
+        eachByte( dest->raw, src1->raw, src2->raw, src2->raw, count * 3UL, BlendBytes( amountOfsrc2));
+    }
+#endif
     return dest;
 }
 
@@ -407,6 +667,132 @@ CHSV* blend( const CHSV* src1, const CHSV* src2, CHSV* dest, uint16_t count, fra
 // the application for use in two-dimensional filter functions.
 uint16_t XY( uint8_t, uint8_t);// __attribute__ ((weak));
 
+// The blur2d, blurRows and blurColumns that take 16 bit sizes and an optional xymap, instead of calling XY().  Each
+// blurred led is keep( itself) + seep( the led before it) + seep( the led after it), from the values before the
+// pass, saturated, which is what the carryover loops of blur1d work out to.  That leaves the order the leds are visited
+// in free, so the column pass goes down the matrix a strip of BLUR_TILE columns at a time, staying within a few
+// cache lines of each row, rather than striding across the whole buffer for every column.
+#if defined(__AVR__)
+#define BLUR_TILE 16
+#else
+#define BLUR_TILE 64
+#endif
+
+// (x, y) is led y * width + x
+struct BlurRowMajor {
+    uint16_t width;
+    BlurRowMajor( uint16_t w) : width( w) {}
+    uint32_t operator()( uint16_t x, uint16_t y) const { return ((uint32_t)y * width) + x; }
+};
+
+// (x, y) is led xymap[y * width + x]
+struct BlurMapped {
+    const uint16_t* xymap;
+    uint16_t width;
+    BlurMapped( const uint16_t* m, uint16_t w) : xymap( m), width( w) {}
+    uint32_t operator()( uint16_t x, uint16_t y) const { return xymap[((uint32_t)y * width) + x]; }
+};
+
+// a led at a time, through an index: the rows as blurRows does them, the columns a strip at a time
+template<class INDEX> static void blurRowsIndexed( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const INDEX& index)
+{
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+    for( uint16_t row = 0; row < height; ++row) {
+        CRGB carryover = CRGB::Black;
+        for( uint16_t i = 0; i < width; ++i) {
+            CRGB& led = leds[index( i, row)];
+            CRGB cur = led;
+            CRGB part = cur;
+            part.nscale8( seep);
+            cur.nscale8( keep);
+            cur += carryover;
+            if( i) leds[index( i - 1, row)] += part;
+            led = cur;
+            carryover = part;
+        }
+    }
+}
+
+template<class INDEX> static void blurColumnsIndexed( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const INDEX& index)
+{
+    uint8_t keep = 255 - blur_amount;
+    uint8_t seep = blur_amount >> 1;
+    CRGB carryover[BLUR_TILE];
+    for( uint32_t col0 = 0; col0 < width; col0 += BLUR_TILE) {
+        uint16_t cols = (width - col0 < BLUR_TILE) ? (width - col0) : BLUR_TILE;
+        for( uint16_t i = 0; i < height; ++i) {
+            for( uint16_t c = 0; c < cols; ++c) {
+                CRGB& led = leds[index( col0 + c, i)];
+                CRGB cur = led;
+                CRGB part = cur;
+                part.nscale8( seep);
+                cur.nscale8( keep);
+                if( i) {
+                    cur += carryover[c];
+                    leds[index( col0 + c, i - 1)] += part;
+                }
+                led = cur;
+                carryover[c] = part;
+            }
+        }
+    }
+}
+
+#if !defined(__AVR__)
+
+// a run of leds in a row, BLUR_TILE at a time.  seeps[j] holds seep of led j - 1 of the tile, from before the
+// tile was blurred, so the leds either side of led j are seeps[j] and seeps[j + 2].
+static void blurRun( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
+{
+    BlurBytes blurBytes( 255 - blur_amount);
+    ScaleBytes seepBytes( blur_amount >> 1);
+    CRGB seeps[BLUR_TILE + 2];
+    seeps[0] = CRGB::Black;
+    for( uint32_t i = 0; i < numLeds; i += BLUR_TILE) {
+        uint16_t n = (numLeds - i < BLUR_TILE) ? (numLeds - i) : BLUR_TILE;
+        // this tile and the led after it, if there is one
+        uint16_t m = (numLeds - i > n) ? (n + 1) : n;
+        eachByte( seeps[1].raw, leds[i].raw, leds[i].raw, leds[i].raw, m * 3UL, seepBytes);
+        if( m == n) seeps[n + 1] = CRGB::Black;
+        eachByte( leds[i].raw, leds[i].raw, seeps[0].raw, seeps[2].raw, n * 3UL, blurBytes);
+        seeps[0] = seeps[n];
+    }
+}
+
+// the columns of a matrix in rows, a strip at a time, each row of the strip blurred with seep of the rows above
+// and below it.  Those are kept in a ring of three, along with seep of the row itself for when the next row is
+// blurred.
+static void blurColumnsRowMajor( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount)
+{
+    BlurBytes blurBytes( 255 - blur_amount);
+    ScaleBytes seepBytes( blur_amount >> 1);
+    CRGB seeps[3][BLUR_TILE];
+    for( uint32_t col0 = 0; col0 < width; col0 += BLUR_TILE) {
+        uint32_t n = (width - col0 < BLUR_TILE) ? (width - col0) : BLUR_TILE;
+        CRGB* above = seeps[0];
+        CRGB* here = seeps[1];
+        CRGB* below = seeps[2];
+        memset( (void*)above, 0, n * sizeof(CRGB));
+        CRGB* row = leds + col0;
+        eachByte( here->raw, row->raw, row->raw, row->raw, n * 3, seepBytes);
+        for( uint16_t i = 0; i < height; ++i, row += width) {
+            if( i + 1 < height) {
+                eachByte( below->raw, row[width].raw, row[width].raw, row[width].raw, n * 3, seepBytes);
+            } else {
+                memset( (void*)below, 0, n * sizeof(CRGB));
+            }
+            eachByte( row->raw, row->raw, above->raw, below->raw, n * 3, blurBytes);
+            CRGB* spare = above;
+            above = here;
+            here = below;
+            below = spare;
+        }
+    }
+}
+
+#endif
+
 
 // blur1d: one-dimensional blur filter. Spreads light to 2 line neighbors.
 // blur2d: two-dimensional blur filter. Spreads light to 8 XY neighbors.
@@ -423,6 +809,9 @@ uint16_t XY( uint8_t, uint8_t);// __attribute__ ((weak));
 //         it can be used to (slowly) clear the LEDs to black.
 void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
 {
+#if !defined(__AVR__)
+    blurRun( leds, numLeds, blur_amount);
+#else
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
     CRGB carryover = CRGB::Black;
@@ -436,6 +825,7 @@ void blur1d( CRGB* leds, uint16_t numLeds, fract8 blur_amount)
         leds[i] = cur;
         carryover = part;
     }
+#endif
 }
 
 void blur2d( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
@@ -490,6 +880,40 @@ void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount)
     }
 }
 
+void blurRows( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    if( xymap) {
+        blurRowsIndexed( leds, width, height, blur_amount, BlurMapped( xymap, width));
+    } else {
+#if defined(__AVR__)
+        blurRowsIndexed( leds, width, height, blur_amount, BlurRowMajor( width));
+#else
+        for( uint16_t row = 0; row < height; ++row) {
+            blurRun( leds + ((uint32_t)row * width), width, blur_amount);
+        }
+#endif
+    }
+}
+
+void blurColumns( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    if( xymap) {
+        blurColumnsIndexed( leds, width, height, blur_amount, BlurMapped( xymap, width));
+    } else {
+#if defined(__AVR__)
+        blurColumnsIndexed( leds, width, height, blur_amount, BlurRowMajor( width));
+#else
+        blurColumnsRowMajor( leds, width, height, blur_amount);
+#endif
+    }
+}
+
+void blur2d( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap)
+{
+    blurRows( leds, width, height, blur_amount, xymap);
+    blurColumns( leds, width, height, blur_amount, xymap);
+}
+
 
 
 // CRGB HeatColor( uint8_t temperature)
@@ -1105,6 +1529,290 @@ CHSV ColorFromPalette( const struct CHSVPalette256& pal, uint8_t index, uint8_t
 }
 
 
+// ColorsFromPalette: the palette indices of a run of leds, stepping along in 8.8 fixed point or from an array
+struct PaletteStep {
+    uint16_t index, step;
+    PaletteStep( uint16_t start, uint16_t inc) : index( start), step( inc) {}
+    uint8_t operator()() { uint8_t i = index >> 8; index += step; return i; }
+};
+
+struct PaletteIndices {
+    const uint8_t* p;
+    PaletteIndices( const uint8_t* indices) : p( indices) {}
+    uint8_t operator()() { return *p++; }
+};
+
+// colors[i] = ColorFromPalette( pal, i, brightness, blendType) for all 256 indices of a palette of SIZE entries,
+// with entries[SIZE] being entries[0] again.  Every entry's run of 256 / SIZE indices blends it into the next one
+// with the same pattern of weights, so with SIMD the blends are scaleBytes of runs of entries, a vector at a time.
+template<int SIZE> static void expandPalette( CRGB* colors, const CRGB* entries, uint8_t brightness, TBlendType blendType)
+{
+    const int STEP = 256 / SIZE;
+#if defined(COLORUTILS_VECTOR_BYTES)
+    typedef byte_pairs_t W;
+    // leds in one repeat of the weight pattern, a whole number of vectors' worth of bytes
+    const int LEDS = ((int)sizeof(W) > STEP) ? (int)sizeof(W) : STEP;
+    const int WORDS = (3 * LEDS) / sizeof(W);
+    const int LANES = sizeof(W) / 2;
+
+    // the weights of each byte, each entry's weight f1 = 255 - f2 going to f1 + 1 with SCALE8_FIXED (scale8 exactly);
+    // the first index of each run is the entry itself, at 256 and 0
+    uint16_t k1[3 * LEDS], k2[3 * LEDS];
+    for( int j = 0; j < LEDS; ++j) {
+        uint8_t lo = j & (STEP - 1);
+        uint8_t f2 = lo * SIZE;
+        bool bEntry = (lo == 0) || (blendType == NOBLEND);
+        for( int c = 0; c < 3; ++c) {
+            k1[(3 * j) + c] = bEntry ? 256 : (255 - f2 + (FASTLED_SCALE8_FIXED == 1));
+            k2[(3 * j) + c] = bEntry ? 0 : (f2 + (FASTLED_SCALE8_FIXED == 1));
+        }
+    }
+    W k1e[WORDS], k1o[WORDS], k2e[WORDS], k2o[WORDS];
+    for( int w = 0; w < WORDS; ++w) {
+        uint16_t e1[LANES], o1[LANES], e2[LANES], o2[LANES];
+        for( int m = 0; m < LANES; ++m) {
+            int b = (w * sizeof(W)) + (2 * m);
+            e1[m] = k1[b];
+            o1[m] = k1[b + 1];
+            e2[m] = k2[b];
+            o2[m] = k2[b + 1];
+        }
+        memcpy( &k1e[w], e1, sizeof(W));
+        memcpy( &k1o[w], o1, sizeof(W));
+        memcpy( &k2e[w], e2, sizeof(W));
+        memcpy( &k2o[w], o2, sizeof(W));
+    }
+
+    int w = 0;
+    for( int i = 0; i < 256; i += sizeof(W)) {
+        CRGB a[sizeof(W)], b[sizeof(W)];
+        for( int j = 0; j < (int)sizeof(W); ++j) {
+            int e = (i + j) / STEP;
+            a[j] = entries[e];
+            b[j] = entries[e + 1];
+        }
+        for( int t = 0; t < 3; ++t, w = (w + 1 == WORDS) ? 0 : (w + 1)) {
+            W wa, wb;
+            memcpy( &wa, a[0].raw + (t * sizeof(W)), sizeof(W));
+            memcpy( &wb, b[0].raw + (t * sizeof(W)), sizeof(W));
+            // the two scaled bytes never add up to more than 255, so no carries cross between them
+            wa = scaleBytes( wa, k1e[w], k1o[w]) + scaleBytes( wb, k2e[w], k2o[w]);
+            memcpy( colors[i].raw + (t * sizeof(W)), &wa, sizeof(W));
+        }
+    }
+#else
+    // each entry as it is, then the indices between it and the next one
+    for( int e = 0; e < SIZE; ++e) {
+        CRGB* run = colors + (e * STEP);
+        const CRGB& e1 = entries[e];
+        const CRGB& e2 = entries[e + 1];
+        run[0] = e1;
+        for( int lo = 1; lo < STEP; ++lo) {
+            if( blendType == NOBLEND) {
+                run[lo] = e1;
+            } else {
+                uint8_t f2 = lo * SIZE;
+                uint8_t f1 = 255 - f2;
+                run[lo] = CRGB( scale8( e1.r, f1) + scale8( e2.r, f2),
+                                scale8( e1.g, f1) + scale8( e2.g, f2),
+                                scale8( e1.b, f1) + scale8( e2.b, f2));
+            }
+        }
+    }
+#endif
+
+    // brightness the way ColorFromPalette does it: scale8( x, brightness + 1), plus 1 for non-zero x unless
+    // SCALE8_FIXED, which is scale8_video
+    if( brightness != 255) {
+        if( brightness == 0) {
+            memset( (void*)colors, 0, 256 * sizeof(CRGB));
+        } else if( FASTLED_SCALE8_FIXED == 1) {
+            nscale8( colors, 256, brightness + 1);
+        } else {
+            nscale8_video( colors, 256, brightness + 1);
+        }
+    }
+}
+
+bool CRGBPaletteCache::update( const CRGB* entries, uint8_t size)
+{
+    if( (size == mSize) && (memcmp( (const void*)mEntries, (const void*)entries, size * sizeof(CRGB)) == 0)) {
+        return false;
+    }
+    memcpy( (void*)mEntries, (const void*)entries, size * sizeof(CRGB));
+    mEntries[size] = mEntries[0];
+    mSize = size;
+    if( size == 16) {
+        mShift = 4;
+        expandPalette<16>( mColors, mEntries, 255, LINEARBLEND);
+    } else {
+        mShift = 3;
+        expandPalette<32>( mColors, mEntries, 255, LINEARBLEND);
+    }
+    return true;
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette16& pal)
+{
+    return update( pal.entries, 16);
+}
+
+bool CRGBPaletteCache::update( const TProgmemRGBPalette16& pal)
+{
+    CRGB entries[16];
+    for( int i = 0; i < 16; ++i) {
+        entries[i] = FL_PGM_READ_DWORD_NEAR( &(pal[0]) + i);
+    }
+    return update( entries, 16);
+}
+
+bool CRGBPaletteCache::update( const CRGBPalette32& pal)
+{
+    return update( pal.entries, 32);
+}
+
+bool CRGBPaletteCache::update( const TProgmemRGBPalette32& pal)
+{
+    CRGB entries[32];
+    for( int i = 0; i < 32; ++i) {
+        entries[i] = FL_PGM_READ_DWORD_NEAR( &(pal[0]) + i);
+    }
+    return update( entries, 32);
+}
+
+#if !defined(__AVR__)
+// With enough leds, ColorsFromPalette works out all 256 colors of a 16 or 32 entry palette first, and then just
+// looks each led's color up; with fewer, it calls ColorFromPalette for each led.
+#define PALETTE_EXPAND_MIN 48
+
+static void expandPalette( CRGB* colors, const CRGBPalette16& pal, uint8_t brightness, TBlendType blendType)
+{
+    CRGB entries[17];
+    memcpy( (void*)entries, pal.entries, sizeof(pal.entries));
+    entries[16] = entries[0];
+    expandPalette<16>( colors, entries, brightness, blendType);
+}
+
+static void expandPalette( CRGB* colors, const TProgmemRGBPalette16& pal, uint8_t brightness, TBlendType blendType)
+{
+    CRGB entries[17];
+    for( int i = 0; i < 16; ++i) {
+        entries[i] = FL_PGM_READ_DWORD_NEAR( &(pal[0]) + i);
+    }
+    entries[16] = entries[0];
+    expandPalette<16>( colors, entries, brightness, blendType);
+}
+
+static void expandPalette( CRGB* colors, const CRGBPalette32& pal, uint8_t brightness, TBlendType blendType)
+{
+    CRGB entries[33];
+    memcpy( (void*)entries, pal.entries, sizeof(pal.entries));
+    entries[32] = entries[0];
+    expandPalette<32>( colors, entries, brightness, blendType);
+}
+
+static void expandPalette( CRGB* colors, const TProgmemRGBPalette32& pal, uint8_t brightness, TBlendType blendType)
+{
+    CRGB entries[33];
+    for( int i = 0; i < 32; ++i) {
+        entries[i] = FL_PGM_READ_DWORD_NEAR( &(pal[0]) + i);
+    }
+    entries[32] = entries[0];
+    expandPalette<32>( colors, entries, brightness, blendType);
+}
+#endif
+
+template<class PALETTE, class INDEX> static void colorsFromPalette( CRGB* leds, uint16_t count, const PALETTE& pal, INDEX index,
+                                                                    uint8_t brightness, TBlendType blendType)
+{
+#if !defined(__AVR__)
+    if( count >= PALETTE_EXPAND_MIN) {
+        CRGB colors[256];
+        expandPalette( colors, pal, brightness, blendType);
+        for( uint16_t i = 0; i < count; ++i) {
+            leds[i] = colors[index()];
+        }
+        return;
+    }
+#endif
+    for( uint16_t i = 0; i < count; ++i) {
+        leds[i] = ColorFromPalette( pal, index(), brightness, blendType);
+    }
+}
+
+// a 256 entry palette needs no expanding, and ColorFromPalette's brightness on it is scale8_video( x, brightness + 1)
+template<class INDEX> static void colorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette256& pal, INDEX index,
+                                                     uint8_t brightness, TBlendType)
+{
+    for( uint16_t i = 0; i < count; ++i) {
+        leds[i] = pal[index()];
+    }
+    if( brightness != 255) {
+        nscale8_video( leds, count, brightness + 1);
+    }
+}
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette16& pal, uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteStep( startIndex, incIndex), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette16& pal,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteIndices( indices), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const TProgmemRGBPalette16& pal, uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteStep( startIndex, incIndex), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const TProgmemRGBPalette16& pal,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteIndices( indices), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette32& pal, uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteStep( startIndex, incIndex), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette32& pal,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteIndices( indices), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const TProgmemRGBPalette32& pal, uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteStep( startIndex, incIndex), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const TProgmemRGBPalette32& pal,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteIndices( indices), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette256& pal, uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteStep( startIndex, incIndex), brightness, blendType);
+}
+
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette256& pal,
+                        uint8_t brightness, TBlendType blendType)
+{
+    colorsFromPalette( leds, count, pal, PaletteIndices( indices), brightness, blendType);
+}
+
+
 void UpscalePalette(const struct CRGBPalette16& srcpal16, struct CRGBPalette256& destpal256)
 {
     for( int i = 0; i < 256; ++i) {
@@ -282,6 +282,18 @@ void nscale8(       CRGB* leds, uint16_t num_leds, uint8_t scale);
 //                  (largely) the same.
 void fadeUsingColor( CRGB* leds, uint16_t numLeds, const CRGB& colormask);
 
+// hdr16to5b - convert 16 bit per channel colors into 8 bit colors plus
+//             a 5 bit per pixel brightness, for leds like the APA102
+//             that have a 5 bit global brightness in each pixel.
+//             Each pixel gets the smallest brightness that still
+//             holds its brightest channel, which leaves the most
+//             8 bit steps for the color.  Every channel then comes
+//             back within 0.6 of an 8 bit step at that brightness,
+//             i.e. within 0.6 * 65535 * brt / (255 * 31) of the
+//             16 bit value.  Black comes out with a brightness of 0.
+CRGB5b hdr16to5b( const CRGB16& hdr);
+void   hdr16to5b( const CRGB16* src, CRGB5b* dest, uint16_t numLeds);
+
 
 // Pixel blending
 //
@@ -339,6 +351,29 @@ void blurRows( CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 // blurColumns: perform a blur1d on each column of a rectangular matrix
 void blurColumns(CRGB* leds, uint8_t width, uint8_t height, fract8 blur_amount);
 
+// blur2d, blurRows and blurColumns for matrices of up to 65535 leds a side, which
+// don't call XY().  With xymap NULL the leds are in rows, one after another: (x,y)
+// is led y * width + x.  Otherwise (x,y) is led xymap[y * width + x], for serpentine
+// or other layouts of up to 65536 leds; every (x,y) must map to a different led.
+// The results are the same as the XY() versions give.
+void blur2d( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+void blurRows( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+void blurColumns( CRGB* leds, uint16_t width, uint16_t height, fract8 blur_amount, const uint16_t* xymap);
+
+// blur2d, blurRows and blurColumns for the matrix an XYMap describes (see xymap.h)
+inline void blur2d( CRGB* leds, const XYMap& xymap, fract8 blur_amount)
+{
+    blur2d( leds, xymap.width(), xymap.height(), blur_amount, xymap.table());
+}
+inline void blurRows( CRGB* leds, const XYMap& xymap, fract8 blur_amount)
+{
+    blurRows( leds, xymap.width(), xymap.height(), blur_amount, xymap.table());
+}
+inline void blurColumns( CRGB* leds, const XYMap& xymap, fract8 blur_amount)
+{
+    blurColumns( leds, xymap.width(), xymap.height(), blur_amount, xymap.table());
+}
+
 
 // CRGB HeatColor( uint8_t temperature)
 //
@@ -1566,16 +1601,145 @@ CHSV ColorFromPalette( const CHSVPalette32& pal,
                       TBlendType blendType=LINEARBLEND);
 
 
+// ColorsFromPalette: ColorFromPalette for a whole run of LEDs at once, giving
+//                    exactly the same colors.
+//                    LED i gets palette index (startIndex + (i * incIndex)) >> 8,
+//                    stepping along the palette in 8.8 fixed point, or with
+//                    the second form, palette index indices[i].
+//                    For a 16 or 32 entry palette and enough LEDs, all 256
+//                    colors are worked out together first, and each LED
+//                    is then just a lookup.
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette16& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette16& pal,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const TProgmemRGBPalette16& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const TProgmemRGBPalette16& pal,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette32& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette32& pal,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const TProgmemRGBPalette32& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const TProgmemRGBPalette32& pal,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND);
+
+void ColorsFromPalette( CRGB* leds, uint16_t count, const CRGBPalette256& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=NOBLEND);
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const CRGBPalette256& pal,
+                        uint8_t brightness=255, TBlendType blendType=NOBLEND);
+
+// ... and for any other palette (the CHSV ones), one ColorFromPalette per LED
+template <typename PALETTE>
+void ColorsFromPalette( CRGB* leds, uint16_t count, const PALETTE& pal,
+                        uint16_t startIndex, uint16_t incIndex,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
+{
+    for( uint16_t i = 0; i < count; ++i) {
+        leds[i] = ColorFromPalette( pal, (uint8_t)(startIndex >> 8), brightness, blendType);
+        startIndex += incIndex;
+    }
+}
+
+template <typename PALETTE>
+void ColorsFromPalette( CRGB* leds, const uint8_t* indices, uint16_t count, const PALETTE& pal,
+                        uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
+{
+    for( uint16_t i = 0; i < count; ++i) {
+        leds[i] = ColorFromPalette( pal, indices[i], brightness, blendType);
+    }
+}
+
+
+// CRGBPaletteCache: a 16 or 32 entry RGB palette worked out into all 256 of
+//                   its blended colors, so that ColorFromPalette on the cache
+//                   is a single table lookup rather than a blend of two
+//                   entries.  The colors are exactly those ColorFromPalette
+//                   gives for the palette itself, at any brightness and with
+//                   either blend type.
+//
+//                   Call update() with the palette before using the cache,
+//                   e.g. once a frame.  The cache keeps a copy of the entries
+//                   it was worked out from, and only works the colors out
+//                   again when they've changed, such as when
+//                   nblendPaletteTowardPalette has moved the palette along.
+//                   An unchanged palette costs one compare of its entries.
+//
+//                   A cache takes a little under 900 bytes of RAM.
+//
+//     CRGBPaletteCache currentColors;
+//     ...
+//     nblendPaletteTowardPalette( currentPalette, targetPalette, 12);
+//     currentColors.update( currentPalette);
+//     for( uint16_t i = 0; i < NUM_LEDS; ++i) {
+//         leds[i] = ColorFromPalette( currentColors, index[i], brightness);
+//     }
+class CRGBPaletteCache {
+    CRGB mColors[256];      // ColorFromPalette( palette, i, 255, LINEARBLEND) for every index i
+    CRGB mEntries[33];      // the palette the colors were worked out from, then its first entry again
+    uint8_t mSize;          // 16 or 32 entries, or 0 before the first update
+    uint8_t mShift;         // index >> mShift is the entry an index starts from
+
+    bool update( const CRGB* entries, uint8_t size);
+
+public:
+    CRGBPaletteCache() : mSize( 0), mShift( 4) {}
+    CRGBPaletteCache( const CRGBPalette16& pal) : mSize( 0), mShift( 4) { update( pal); }
+    CRGBPaletteCache( const TProgmemRGBPalette16& pal) : mSize( 0), mShift( 4) { update( pal); }
+    CRGBPaletteCache( const CRGBPalette32& pal) : mSize( 0), mShift( 4) { update( pal); }
+    CRGBPaletteCache( const TProgmemRGBPalette32& pal) : mSize( 0), mShift( 4) { update( pal); }
+
+    // bring the colors up to date with pal.  Returns true if they had to be
+    // worked out again, false if pal was the same as last time.
+    bool update( const CRGBPalette16& pal);
+    bool update( const TProgmemRGBPalette16& pal);
+    bool update( const CRGBPalette32& pal);
+    bool update( const TProgmemRGBPalette32& pal);
+
+    // ColorFromPalette( palette, index, brightness, blendType)
+    CRGB color( uint8_t index, uint8_t brightness=255, TBlendType blendType=LINEARBLEND) const
+    {
+        CRGB c = (blendType == NOBLEND) ? mEntries[index >> mShift] : mColors[index];
+        if( brightness != 255) {
+            if( brightness ) {
+                ++brightness; // adjust for rounding, as ColorFromPalette does
+                if( c.red )   { c.red   = scale8_LEAVING_R1_DIRTY( c.red,   brightness) + !(FASTLED_SCALE8_FIXED == 1); }
+                if( c.green ) { c.green = scale8_LEAVING_R1_DIRTY( c.green, brightness) + !(FASTLED_SCALE8_FIXED == 1); }
+                if( c.blue )  { c.blue  = scale8_LEAVING_R1_DIRTY( c.blue,  brightness) + !(FASTLED_SCALE8_FIXED == 1); }
+                cleanup_R1();
+            } else {
+                c = CRGB( 0, 0, 0);
+            }
+        }
+        return c;
+    }
+};
+
+inline CRGB ColorFromPalette( const CRGBPaletteCache& cache,
+                              uint8_t index,
+                              uint8_t brightness=255,
+                              TBlendType blendType=LINEARBLEND)
+{
+    return cache.color( index, brightness, blendType);
+}
+
+
 // Fill a range of LEDs with a sequence of entries from a palette
 template <typename PALETTE>
 void fill_palette(CRGB* L, uint16_t N, uint8_t startIndex, uint8_t incIndex,
                   const PALETTE& pal, uint8_t brightness=255, TBlendType blendType=LINEARBLEND)
 {
-    uint8_t colorIndex = startIndex;
-    for( uint16_t i = 0; i < N; ++i) {
-        L[i] = ColorFromPalette( pal, colorIndex, brightness, blendType);
-        colorIndex += incIndex;
-    }
+    ColorsFromPalette( L, N, pal, ((uint16_t)startIndex) << 8, ((uint16_t)incIndex) << 8, brightness, blendType);
 }
 
 // Fill a range of LEDs with a sequence of entries from a palette, so that
@@ -1589,12 +1753,8 @@ void fill_palette_circular(CRGB* L, uint16_t N, uint8_t startIndex,
 
     const uint16_t colorChange = 65535 / N;              // color change for each LED, * 256 for precision
     uint16_t colorIndex = ((uint16_t) startIndex) << 8;  // offset for color index, with precision (*256)
- 
-   for (uint16_t i = 0; i < N; ++i) {
-        L[i] = ColorFromPalette(pal, (colorIndex >> 8), brightness, blendType);
-        if (reversed) colorIndex -= colorChange;
-        else colorIndex += colorChange;
-    }
+
+    ColorsFromPalette( L, N, pal, colorIndex, reversed ? (uint16_t)(0 - colorChange) : colorChange, brightness, blendType);
 }
 
 template <typename PALETTE>
@@ -1606,16 +1766,16 @@ void map_data_into_colors_through_palette(
 	uint8_t opacity=255,
 	TBlendType blendType=LINEARBLEND)
 {
+	if( opacity == 255 ) {
+		ColorsFromPalette( targetColorArray, dataArray, dataCount, pal, brightness, blendType);
+		return;
+	}
 	for( uint16_t i = 0; i < dataCount; ++i) {
 		uint8_t d = dataArray[i];
 		CRGB rgb = ColorFromPalette( pal, d, brightness, blendType);
-		if( opacity == 255 ) {
-			targetColorArray[i] = rgb;
-		} else {
-			targetColorArray[i].nscale8( 256 - opacity);
-			rgb.nscale8_video( opacity);
-			targetColorArray[i] += rgb;
-		}
+		targetColorArray[i].nscale8( 256 - opacity);
+		rgb.nscale8_video( opacity);
+		targetColorArray[i] += rgb;
 	}
 }
 
@@ -8,7 +8,9 @@
 #include "led_sysdefs.h"
 #include "pixeltypes.h"
 #include "color.h"
+#include "frame_buffer.h"
 #include <stddef.h>
+#include <stdlib.h>
 
 FASTLED_NAMESPACE_BEGIN
 
@@ -19,22 +21,49 @@ FASTLED_NAMESPACE_BEGIN
 #define RGB_BYTE1(RO) ((RO>>3) & 0x3)
 #define RGB_BYTE2(RO) ((RO) & 0x3)
 
-//  for 5-bit brightness, 4byte val: - NLG
-#define RO5b(X) RGB5b_BYTE(RGB_ORDER, X)
-// TODO: Edit EOrder, include RGBbrt and skip conditional
-// brt is fixed at [3]
-#define RGB5b_BYTE(RO5b,X) (X==3 ? X : (((RO5b)>>(3*(2-(X)))) & 0x3))
-
-// #define RGB5b_BYTE0(RO5b) ((RO5b>>6) & 0x3)
-// #define RGB5b_BYTE1(RO5b) ((RO5b>>3) & 0x3)
-// #define RGB5b_BYTE2(RO5b) ((RO5b) & 0x3)
-
 // operator byte *(struct CRGB[] arr) { return (byte*)arr; }
 
 #define DISABLE_DITHER 0x00
 #define BINARY_DITHER 0x01
+/// Per pixel error diffusion (sigma-delta): each pixel keeps the part of its scaled value that was lost to rounding,
+/// and carries it into the next frame, so the output averages out to the exact value over a few frames.  Takes
+/// 2 bytes of ram per led.  Works with output code that goes through PixelController::loadAndScale (the AVR and
+/// Cortex-M0 clockless asm fall back to no dithering).  Needs FASTLED_ERROR_DIFFUSION (see fastled_config.h), without
+/// which it is the same as BINARY_DITHER.
+#define ERROR_DIFFUSION_DITHER 0x02
 typedef uint8_t EDitherMode;
 
+// Temporal dithering cycles through 2^n frames, and flickers visibly if a whole cycle takes longer than
+// 1/MIN_ACCEPTABLE_DITHER_RATE_HZ.  VIRTUAL_BITS, what MAX_LIKELY_UPDATE_RATE_HZ allows, is the number of bits binary
+// dithering uses, and FastLED.show turns dithering off while it runs at under 100fps.  With FASTLED_ADAPTIVE_DITHER,
+// controllers instead pick n from their measured frame interval, so a strip refreshed at 400Hz gets 3 bits of
+// dithering, one refreshed at 100Hz gets 1 bit, and one refreshed at less than 100Hz none.  Error diffusion keeps up
+// to DIFFUSION_BITS bits per channel.
+#ifndef MIN_ACCEPTABLE_DITHER_RATE_HZ
+#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
+#endif
+#define MAX_LIKELY_UPDATE_RATE_HZ     400
+#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
+#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
+                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
+#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
+#define DIFFUSION_BITS 4
+
+/// Wire time, in microseconds, of nLeds leds on a clockless output (see chipsets.h): each bit takes BIT_CLOCKS
+/// (T1 + T2 + T3) clocks, each byte is followed by XTRA0 zero bits, and the leds latch once the line has been held
+/// low for LATCH_MICROS (WAIT_TIME).  Block outputs send LANES strips at once, nLeds being the total of all of them.
+template<int BIT_CLOCKS, int XTRA0, int LATCH_MICROS, int LANES = 1>
+inline uint32_t clocklessWireMicros(int nLeds) {
+    uint32_t nLaneLeds = (nLeds + LANES - 1) / LANES;
+    return (nLaneLeds * (3 * (8 + XTRA0) * BIT_CLOCKS)) / CLOCKLESS_CLKS_PER_US + LATCH_MICROS;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // LED Controller interface definition
@@ -50,13 +79,46 @@ class CLEDController {
 protected:
     friend class CFastLED;
     CRGB *m_Data;
-    uint8_t *b_Data; // nlg - only used for APA101WB.  Cleanup for memory usage before merging into general-FastLED.
-    CRGB5b *mb_Data;
+#if FASTLED_TRIPLE_BUFFER == 1
+    CFrameSource *m_pFrames;        // frame buffer the led data is taken from, if any (see setLeds(CFrameBuffer&))
+#endif
     CLEDController *m_pNext;
     CRGB m_ColorCorrection;
     CRGB m_ColorTemperature;
     EDitherMode m_DitherMode;
+#if defined(FASTLED_HAS_SHOW_POOL)
+    uint8_t m_nShowGroup;           // controllers in the same nonzero group are shown one after another
+#endif
+#if FASTLED_ADAPTIVE_DITHER == 1
+    uint8_t m_nDitherFrame;         // position in the dither cycle
+    uint32_t m_nLastFrameMicros;    // when the last frame was started
+    uint32_t m_nFrameMicros;        // smoothed time between frames, which sets the number of dither bits
+#else
+    static bool m_bDitherOff;       // set while FastLED.show runs at under 100fps
+#endif
+#if FASTLED_ERROR_DIFFUSION == 1
+    uint16_t *m_pResidual;          // ERROR_DIFFUSION_DITHER residuals, allocated the first time they're needed
+    int m_nResidual;
+#endif
     int m_nLeds;
+#if FASTLED_POWER_FUSED == 1
+    // unscaled r, g and b totals of the last frame written out, and the number of pixels that went into them
+    uint32_t m_PowerAccum[4];
+#endif
+#if FASTLED_OUTPUT_MAP == 1
+    // the order the leds are written out in (see setOutputMap), NULL for the order they're in
+    const uint16_t *m_pOutputMap;
+#endif
+#if FASTLED_SKIP_UNCHANGED == 1
+    // hash of the last frame FastLED.show wrote out (led data, color adjustment and dither mode), and when it went out
+    uint32_t m_nFrameHash;
+    uint32_t m_nFrameMillis;
+    bool m_bFrameValid;
+    bool m_bSkipFrame;              // FastLED.show is leaving this controller out of the frame
+#endif
+#if FASTLED_STATS == 1
+    CLEDStats m_Stats;
+#endif
     static CLEDController *m_pHead;
     static CLEDController *m_pTail;
 
@@ -72,25 +134,141 @@ protected:
     ///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale) = 0;
 
-    /// write the passed in rgb data out to the leds managed by this controller
-    ///@param data the rgb data to write out to the strip
-    ///@param bdata the brightness data to write out to the strip (0-31)
-    ///@param nLeds the number of leds being written out
-    ///@param scale the rgb scaling to apply to each led before writing it out
-    virtual void show(const struct CRGB *data, uint8_t *bdata, int nLeds, CRGB scale) = 0;
+    /// point the pixel controller at this controller's power accumulator, so that the color totals of the frame
+    /// are summed up as the frame is encoded.  Does nothing unless FASTLED_POWER_FUSED is set.
+    template<class PIXELS> void beginPowerAccounting(PIXELS & pixels) {
+#if FASTLED_POWER_FUSED == 1
+        m_PowerAccum[0] = m_PowerAccum[1] = m_PowerAccum[2] = m_PowerAccum[3] = 0;
+        pixels.mPowerAccum = m_PowerAccum;
+#else
+        (void)pixels;
+#endif
+    }
 
-    /// write the passed in rgb +5brt data out to the leds managed by this controller
-    ///@param data the rgb data to write out to the strip
-    ///@param nLeds the number of leds being written out
-    ///@param scale the rgb scaling to apply to each led before writing it out
-    virtual void show(const struct CRGB5b *data, int nLeds, CRGB scale) = 0;
+    /// finish off the totals of a frame started with beginPowerAccounting.  Formats with a per pixel brightness
+    /// summed color * brightness, which is brought back into the 0-255 range here.
+    template<class PIXELS> void endPowerAccounting(PIXELS & pixels) {
+#if FASTLED_POWER_FUSED == 1
+        pixels.flushPower();
+        if(PIXELS::Format::BRIGHTNESS) {
+            m_PowerAccum[0] /= 31;
+            m_PowerAccum[1] /= 31;
+            m_PowerAccum[2] /= 31;
+        }
+#else
+        (void)pixels;
+#endif
+    }
+
+    /// start a new frame's dithering on the pixel controller: steps the dither cycle, which with
+    /// FASTLED_ADAPTIVE_DITHER is this controller's own, sized from the time since the last frame.  Pixel controllers
+    /// should be created with DISABLE_DITHER, and set up here.
+    template<class PIXELS> void beginDithering(PIXELS & pixels) {
+#if FASTLED_ADAPTIVE_DITHER == 1
+        timeFrame();
+        if(m_DitherMode == BINARY_DITHER) {
+            pixels.init_binary_dithering(++m_nDitherFrame, getDitherBits());
+        }
+#else
+        if(m_DitherMode == BINARY_DITHER) {
+            if(!m_bDitherOff) { pixels.init_binary_dithering(); }
+        }
+#endif
+#if (FASTLED_ERROR_DIFFUSION == 1) && (!defined(NO_DITHERING) || (NO_DITHERING != 1))
+        else if(m_DitherMode == ERROR_DIFFUSION_DITHER) {
+            uint8_t bits = getDitherBits();
+            if(bits && reserveResiduals(pixels.mLen * PIXELS::NUM_LANES)) {
+                pixels.mResidual = m_pResidual;
+                pixels.mResidualBits = bits;
+            }
+        }
+#endif
+    }
+
+#if FASTLED_ADAPTIVE_DITHER == 1
+    /// count the start of a frame towards the frame interval that sizes the dither cycle.  FastLED.show calls this
+    /// for frames it leaves out (see FASTLED_SKIP_UNCHANGED), so the cycle follows the show rate.
+    void timeFrame() {
+        uint32_t now = micros();
+        uint32_t interval = now - m_nLastFrameMicros;
+        m_nLastFrameMicros = now;
+        if(interval > 0xFFFFF) { interval = 0xFFFFF; }
+        // average over a few frames, so that a single late frame doesn't change the cycle length
+        m_nFrameMicros = (m_nFrameMicros * 3 + interval) >> 2;
+    }
+#endif
+
+    /// have the pixel controller gather the leds in the order of this controller's output map, if it has one.  Call
+    /// after anything that changes the pixel controller's data pointer or direction.
+    template<class PIXELS> void beginOutputMap(PIXELS & pixels) {
+#if FASTLED_OUTPUT_MAP == 1
+        if(m_pOutputMap) { pixels.setMap(m_pOutputMap); }
+#else
+        (void)pixels;
+#endif
+    }
+
+#if FASTLED_ERROR_DIFFUSION == 1
+    /// make room for error diffusion residuals for n pixels.  Returns false if they couldn't be allocated.
+    bool reserveResiduals(int n) {
+        if(n > m_nResidual) {
+            uint16_t *pResidual = (uint16_t*)realloc(m_pResidual, n * sizeof(uint16_t));
+            if(pResidual == NULL) { return false; }
+            memset8((void*)(pResidual + m_nResidual), 0, (n - m_nResidual) * sizeof(uint16_t));
+            m_pResidual = pResidual;
+            m_nResidual = n;
+        }
+        return true;
+    }
+#endif
+
+#if FASTLED_TRIPLE_BUFFER == 1
+    /// attach a frame buffer, starting from the frame it's showing now
+    CLEDController & setFrames(CFrameSource & frames) {
+        m_pFrames = &frames;
+        m_nLeds = frames.size();
+        useFrame();
+        return *this;
+    }
+
+    /// point the led data at the front frame of the attached frame buffer
+    virtual void useFrame() { m_Data = (CRGB*)m_pFrames->frontPixels(); }
+#endif
 
 public:
     /// create an led controller object, add it to the chain of controllers
-    // CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
-    // Including brightness data in general constructor list - though only used for APA102WB. Cleanup before generalizing. - NLG
-    CLEDController() : m_Data(NULL), b_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
+    CLEDController() : m_Data(NULL), m_ColorCorrection(UncorrectedColor), m_ColorTemperature(UncorrectedTemperature), m_DitherMode(BINARY_DITHER), m_nLeds(0) {
         m_pNext = NULL;
+#if FASTLED_TRIPLE_BUFFER == 1
+        m_pFrames = NULL;
+#endif
+#if defined(FASTLED_HAS_SHOW_POOL)
+        m_nShowGroup = 0;
+#endif
+#if FASTLED_ADAPTIVE_DITHER == 1
+        m_nDitherFrame = 0;
+        m_nLastFrameMicros = 0;
+        m_nFrameMicros = 0xFFFFF;
+#endif
+#if FASTLED_ERROR_DIFFUSION == 1
+        m_pResidual = NULL;
+        m_nResidual = 0;
+#endif
+#if FASTLED_POWER_FUSED == 1
+        m_PowerAccum[0] = m_PowerAccum[1] = m_PowerAccum[2] = m_PowerAccum[3] = 0;
+#endif
+#if FASTLED_OUTPUT_MAP == 1
+        m_pOutputMap = NULL;
+#endif
+#if FASTLED_SKIP_UNCHANGED == 1
+        m_nFrameHash = 0;
+        m_nFrameMillis = 0;
+        m_bFrameValid = false;
+        m_bSkipFrame = false;
+#endif
+#if FASTLED_STATS == 1
+        resetStats();
+#endif
         if(m_pHead==NULL) { m_pHead = this; }
         if(m_pTail != NULL) { m_pTail->m_pNext = this; }
         m_pTail = this;
@@ -107,39 +285,23 @@ public:
         show(data, nLeds, getAdjustment(brightness));
     }
 
-    /// show function w/integer brightness, will scale for color correction and temperature
-    void show(const struct CRGB *data, uint8_t *bdata, int nLeds, uint8_t brightness) {
-        show(data, bdata, nLeds, getAdjustment(brightness));
-    }
-
-    /// show function w/integer brightness, will scale for color correction and temperature
-    void show(const struct CRGB5b *data, int nLeds, uint8_t brightness) {
-        show(data, nLeds, getAdjustment(brightness));
-    }
-
     /// show function w/integer brightness, will scale for color correction and temperature
     void showColor(const struct CRGB &data, int nLeds, uint8_t brightness) {
         showColor(data, nLeds, getAdjustment(brightness));
     }
 
     /// show function using the "attached to this controller" led data
-    void showLeds(uint8_t brightness=255) {
+    virtual void showLeds(uint8_t brightness=255) {
         show(m_Data, m_nLeds, getAdjustment(brightness));
     }
 
-    /// show function using the "attached to this controller" led data
-    /// Including per-pixel brightness data (in addition to standard
-    /// global brightness adjustment)
-    void showLedsW5b(uint8_t brightness=255) {
-        show(mb_Data, m_nLeds, getAdjustment(brightness));
-    }
+    /// start writing out the "attached to this controller" led data and return without waiting for it to go out.  Only
+    /// controllers whose output runs in the background from their own copy of the data (dma, interrupts, a peripheral)
+    /// can do this - the default returns false without showing anything, and the caller falls back to showLeds.
+    virtual bool showLedsAsync(uint8_t /*brightness*/=255) { return false; }
 
-    /// show function using the "attached to this controller" led data
-    /// Including per-pixel brightness data (in addition to standard
-    /// global brightness adjustment)
-    void showLedsWB(uint8_t brightness=255) {
-        show(m_Data, b_Data, m_nLeds, getAdjustment(brightness));
-    }
+    /// wait for output started by showLedsAsync to finish
+    virtual void waitShowComplete() { }
 
     /// show the given color on the led strip
     void showColor(const struct CRGB & data, uint8_t brightness=255) {
@@ -154,27 +316,30 @@ public:
     /// set the default array of leds to be used by this controller
     CLEDController & setLeds(CRGB *data, int nLeds) {
         m_Data = data;
+#if FASTLED_TRIPLE_BUFFER == 1
+        m_pFrames = NULL;
+#endif
         m_nLeds = nLeds;
         return *this;
     }
 
-    /// set the default array of leds (with brightness) to be used by this controller
-    CLEDController & setLeds(CRGB *data, uint8_t *bdata, int nLeds) {
-        m_Data = data;
-        b_Data = bdata;
-        m_nLeds = nLeds;
-        return *this;
+#if FASTLED_TRIPLE_BUFFER == 1
+    /// take the led data from a frame buffer, showing the newest frame published to it (see frame_buffer.h).  Any
+    /// per pixel brightness in the frames is only used by a CBrightnessLEDController.
+    template<int SIZE, bool BRIGHTNESS> CLEDController & setLeds(CFrameBuffer<CRGB, SIZE, BRIGHTNESS> & frames) {
+        return setFrames(frames);
     }
 
-    /// set the default array of leds (with brightness) to be used by this controller
-    CLEDController & setLeds(CRGB5b *data, int nLeds) {
-        mb_Data = data;
-        m_nLeds = nLeds;
-        return *this;
+    /// switch to the newest frame published to the attached frame buffer, if there is a new one.  FastLED.show and
+    /// showAsync call this before looking at any led data; call it before showLeds when showing this controller
+    /// directly.
+    void latchFrame() {
+        if(m_pFrames && m_pFrames->acquire()) { useFrame(); }
     }
+#endif
 
     /// zero out the led data managed by this controller
-    void clearLedData() {
+    virtual void clearLedData() {
         if(m_Data) {
             memset8((void*)m_Data, 0, sizeof(struct CRGB) * m_nLeds);
         }
@@ -186,14 +351,95 @@ public:
     /// Pointer to the CRGB array for this controller
     CRGB* leds() { return m_Data; }
 
+    /// Per pixel brightness attached to this controller: a separate array of 5 bit brightness values for leds(), or
+    /// interleaved CRGB5b data (in which case leds() is NULL).  Both are NULL unless this is a CBrightnessLEDController.
+    virtual uint8_t *brightnessData() { return NULL; }
+    virtual CRGB5b *leds5b() { return NULL; }
+
+#if FASTLED_POWER_FUSED == 1
+    /// Unscaled r, g and b totals and pixel count of the last frame this controller wrote out, or NULL if the
+    /// output code doesn't walk the data through PixelController::advanceData (so nothing was counted)
+    const uint32_t *lastFramePower() const { return (m_nLeds && m_PowerAccum[3] >= (uint32_t)m_nLeds) ? m_PowerAccum : NULL; }
+#endif
+
+#if FASTLED_OUTPUT_MAP == 1
+    /// Write the leds out in the order map gives, rather than the order they're in: the n'th led out is led map[n] of
+    /// the led data.  The leds can then be drawn in whatever order is easiest (rows of a matrix, say) however they're
+    /// wired, and are put in wire order as each frame is encoded, with no copy.  The map needs an entry for each led
+    /// shown, each less than the number of leds; on block (multi lane) controllers every lane's strip goes through
+    /// the same map, within its own part of the data.  The map isn't copied.  NULL goes back to the order the leds
+    /// are in.
+    CLEDController & setOutputMap(const uint16_t *map) {
+        m_pOutputMap = map;
+#if FASTLED_SKIP_UNCHANGED == 1
+        m_bFrameValid = false;
+#endif
+        return *this;
+    }
+    /// get the output map, NULL if there isn't one
+    const uint16_t *getOutputMap() const { return m_pOutputMap; }
+#endif
+
+#if FASTLED_SKIP_UNCHANGED == 1
+    /// Forget the last frame written out, so the next FastLED.show writes this controller out even if nothing has
+    /// changed.  Needed after showing this controller directly (e.g. with showLeds) rather than through FastLED.show.
+    void invalidateFrame() { m_bFrameValid = false; }
+#endif
+
+#if FASTLED_STATS == 1
+    /// Frame timing statistics for this controller (see fastled_stats.h)
+    CLEDStats & getStats() { return m_Stats; }
+    /// Zero this controller's frame timing statistics
+    void resetStats() { memset8((void*)&m_Stats, 0, sizeof(m_Stats)); }
+#endif
+
     /// Reference to the n'th item in the controller
     CRGB &operator[](int x) { return m_Data[x]; }
 
     /// set the dithering mode for this controller to use
-    inline CLEDController & setDither(uint8_t ditherMode = BINARY_DITHER) { m_DitherMode = ditherMode; return *this; }
+    inline CLEDController & setDither(uint8_t ditherMode = BINARY_DITHER) {
+#if FASTLED_ERROR_DIFFUSION != 1
+        if(ditherMode == ERROR_DIFFUSION_DITHER) { ditherMode = BINARY_DITHER; }
+#endif
+        m_DitherMode = ditherMode;
+        return *this;
+    }
     /// get the dithering option currently set for this controller
     inline uint8_t getDither() { return m_DitherMode; }
 
+    /// set the show group for this controller.  With more than one show worker (see FastLED.setShowWorkers) each group
+    /// is written out by one worker, all of its controllers one after another, so controllers that share anything (a
+    /// bus, a dma channel, buffers) must share a group.  Controllers left in group 0, the default, can each go to any
+    /// worker.  Only platforms with a show pool keep the group, elsewhere there is only the calling thread.
+#if defined(FASTLED_HAS_SHOW_POOL)
+    inline CLEDController & setShowGroup(uint8_t group) { m_nShowGroup = group; return *this; }
+    /// get the show group of this controller
+    inline uint8_t getShowGroup() { return m_nShowGroup; }
+#else
+    inline CLEDController & setShowGroup(uint8_t) { return *this; }
+    /// get the show group of this controller
+    inline uint8_t getShowGroup() { return 0; }
+#endif
+
+    /// get how many bits of temporal dithering this controller uses: VIRTUAL_BITS (DIFFUSION_BITS for error
+    /// diffusion), none while FastLED.show runs at under 100fps.  With FASTLED_ADAPTIVE_DITHER, the most that still
+    /// fit a whole dither cycle of this controller's frames into 1/MIN_ACCEPTABLE_DITHER_RATE_HZ, up to the same.
+    /// 0 when dithering is disabled.
+    uint8_t getDitherBits() {
+        uint8_t maxBits = (m_DitherMode == BINARY_DITHER) ? VIRTUAL_BITS : (m_DitherMode == ERROR_DIFFUSION_DITHER) ? DIFFUSION_BITS : 0;
+#if FASTLED_ADAPTIVE_DITHER == 1
+        uint8_t bits = 0;
+        uint32_t cycle = m_nFrameMicros << 1;
+        while(bits < maxBits && cycle <= (1000000UL / MIN_ACCEPTABLE_DITHER_RATE_HZ)) {
+            ++bits;
+            cycle <<= 1;
+        }
+        return bits;
+#else
+        return m_bDitherOff ? 0 : maxBits;
+#endif
+    }
+
     /// the the color corrction to use for this controller, expressed as an rgb object
     CLEDController & setCorrection(CRGB correction) { m_ColorCorrection = correction; return *this; }
     /// set the color correction to use for this controller
@@ -235,18 +481,160 @@ public:
       #endif
     }
     virtual uint16_t getMaxRefreshRate() const { return 0; }
+
+    /// whether this controller's output only starts once every controller of its kind has been shown in the frame,
+    /// as with drivers that send all of their strips at once (the ESP32 RMT and I2S drivers).  FastLED.show then
+    /// only skips it (see FASTLED_SKIP_UNCHANGED) when all of them are unchanged.
+    virtual bool showsInBatch() const { return false; }
+
+    /// Get the time, in microseconds, that nLeds leds take to go out on the wire: the led data, any start and end
+    /// frames, and the time the leds need to latch before the next frame.  This is the floor on the frame time, not
+    /// counting the time taken to encode the data (which on most outputs overlaps the sending).
+    /// @returns the wire time, or 0 if this controller can't tell
+    virtual uint32_t getWireMicros(int /*nLeds*/) const { return 0; }
+
+    /// Get the wire time (see getWireMicros) of a frame of this controller's leds
+    uint32_t getFrameWireMicros() { return getWireMicros(size()); }
 };
 
+/// Base for controllers whose chipset has a per pixel brightness field (APA102WB).  On top of CRGB data these can be
+/// attached to CRGB data plus a separate array of brightness values, or to interleaved CRGB5b data.  Kept out of
+/// CLEDController so controllers for every other chipset don't carry the extra pointers and virtuals.
+class CBrightnessLEDController : public CLEDController {
+protected:
+    uint8_t *b_Data;
+    CRGB5b *mb_Data;
+
+    /// write the passed in rgb data out to the leds managed by this controller
+    ///@param data the rgb data to write out to the strip
+    ///@param bdata the brightness data to write out to the strip (0-31)
+    ///@param nLeds the number of leds being written out
+    ///@param scale the rgb scaling to apply to each led before writing it out
+    virtual void show(const struct CRGB *data, uint8_t *bdata, int nLeds, CRGB scale) = 0;
+
+    /// write the passed in rgb +5brt data out to the leds managed by this controller
+    ///@param data the rgb data to write out to the strip
+    ///@param nLeds the number of leds being written out
+    ///@param scale the rgb scaling to apply to each led before writing it out
+    virtual void show(const struct CRGB5b *data, int nLeds, CRGB scale) = 0;
+
+public:
+    CBrightnessLEDController() : CLEDController(), b_Data(NULL), mb_Data(NULL) {}
+
+    using CLEDController::show;
+    using CLEDController::setLeds;
+
+    /// show function w/integer brightness, will scale for color correction and temperature
+    void show(const struct CRGB *data, uint8_t *bdata, int nLeds, uint8_t brightness) {
+        show(data, bdata, nLeds, getAdjustment(brightness));
+    }
+
+    /// show function w/integer brightness, will scale for color correction and temperature
+    void show(const struct CRGB5b *data, int nLeds, uint8_t brightness) {
+        show(data, nLeds, getAdjustment(brightness));
+    }
+
+    /// show function using the "attached to this controller" led data, with its per pixel brightness data.  CRGB5b
+    /// data is attached with m_Data NULL; a plain setLeds(CRGB*) on top of it is shown without brightness.
+    virtual void showLeds(uint8_t brightness=255) {
+        if(m_Data == NULL) {
+            show(mb_Data, m_nLeds, getAdjustment(brightness));
+        } else if(b_Data) {
+            show(m_Data, b_Data, m_nLeds, getAdjustment(brightness));
+        } else {
+            show(m_Data, m_nLeds, getAdjustment(brightness));
+        }
+    }
+
+protected:
+#if FASTLED_TRIPLE_BUFFER == 1
+    virtual void useFrame() {
+        if(m_pFrames->pixelBytes() == sizeof(CRGB5b)) {
+            m_Data = NULL;
+            b_Data = NULL;
+            mb_Data = (CRGB5b*)m_pFrames->frontPixels();
+        } else {
+            m_Data = (CRGB*)m_pFrames->frontPixels();
+            b_Data = m_pFrames->frontBrightness();
+            mb_Data = NULL;
+        }
+    }
+#endif
+
+public:
+    virtual uint8_t *brightnessData() { return m_Data ? b_Data : NULL; }
+    virtual CRGB5b *leds5b() { return m_Data ? NULL : mb_Data; }
+
+    /// set the default array of leds (with brightness) to be used by this controller
+    CBrightnessLEDController & setLeds(CRGB *data, uint8_t *bdata, int nLeds) {
+        m_Data = data;
+        b_Data = bdata;
+        mb_Data = NULL;
+#if FASTLED_TRIPLE_BUFFER == 1
+        m_pFrames = NULL;
+#endif
+        m_nLeds = nLeds;
+        return *this;
+    }
+
+    /// set the default array of leds (with brightness) to be used by this controller
+    CBrightnessLEDController & setLeds(CRGB5b *data, int nLeds) {
+        m_Data = NULL;
+        b_Data = NULL;
+        mb_Data = data;
+#if FASTLED_TRIPLE_BUFFER == 1
+        m_pFrames = NULL;
+#endif
+        m_nLeds = nLeds;
+        return *this;
+    }
+
+#if FASTLED_TRIPLE_BUFFER == 1
+    /// take the led data (with brightness) from a frame buffer of CRGB5b, showing the newest frame published to it
+    template<int SIZE, bool BRIGHTNESS> CBrightnessLEDController & setLeds(CFrameBuffer<CRGB5b, SIZE, BRIGHTNESS> & frames) {
+        setFrames(frames);
+        return *this;
+    }
+#endif
+
+    /// zero out the led data managed by this controller
+    virtual void clearLedData() {
+        CLEDController::clearLedData();
+        if(m_Data == NULL && mb_Data) {
+            memset8((void*)mb_Data, 0, sizeof(struct CRGB5b) * m_nLeds);
+        }
+    }
+};
+
+/// Layout of the led data a PixelController walks.  Picked at compile time so each controller gets an inner loop
+/// for exactly the data it was handed.
+enum EPixelFormat {
+    PIXEL_RGB8 = 0,     ///< CRGB
+    PIXEL_RGB8_BRT,     ///< CRGB, plus a separate array of 5 bit brightness values
+    PIXEL_RGB5B,        ///< CRGB5b - r,g,b,brt interleaved
+    PIXEL_RGB16         ///< CRGB16, the high byte of each channel is output
+};
+
+/// Per format constants used by PixelController.  BYTES is the size of one pixel, CHANNEL_BYTES the size of
+/// one channel (the byte loaded is the high byte of the channel), and BRIGHTNESS says where a per pixel
+/// brightness lives: 0 for none, 1 for a separate array, 2 for interleaved in byte 3 of the pixel.
+template<EPixelFormat FORMAT> struct PixelFormat;
+template<> struct PixelFormat<PIXEL_RGB8>     { typedef CRGB   pixel_t; static const int BYTES = 3, CHANNEL_BYTES = 1, BRIGHTNESS = 0; };
+template<> struct PixelFormat<PIXEL_RGB8_BRT> { typedef CRGB   pixel_t; static const int BYTES = 3, CHANNEL_BYTES = 1, BRIGHTNESS = 1; };
+template<> struct PixelFormat<PIXEL_RGB5B>    { typedef CRGB5b pixel_t; static const int BYTES = 4, CHANNEL_BYTES = 1, BRIGHTNESS = 2; };
+template<> struct PixelFormat<PIXEL_RGB16>    { typedef CRGB16 pixel_t; static const int BYTES = 6, CHANNEL_BYTES = 2, BRIGHTNESS = 0; };
+
 // Pixel controller class.  This is the class that we use to centralize pixel access in a block of data, including
 // support for things like RGB reordering, scaling, dithering, skipping (for ARGB data), and eventually, we will
 // centralize 8/12/16 conversions here as well.
-template<EOrder RGB_ORDER, int LANES=1, uint32_t MASK=0xFFFFFFFF>
+template<EOrder RGB_ORDER, int LANES=1, uint32_t MASK=0xFFFFFFFF, EPixelFormat FORMAT=PIXEL_RGB8>
 struct PixelController {
+        typedef PixelFormat<FORMAT> Format;
+        static const int NUM_LANES = LANES;
+
         const uint8_t *mData;
+        // separate brightness array, only walked for PIXEL_RGB8_BRT
         const uint8_t *bData;
-        // default uses only mData
-        // perpixel brightness can use mdata+bdata or mbdata
-        const uint8_t *mbData;
         int mLen,mLenRemaining;
         uint8_t d[3];
         uint8_t e[3];
@@ -254,7 +642,41 @@ struct PixelController {
         int8_t mAdvance;
         int8_t bAdvance;
         int mOffsets[LANES];
-        int mbOffsets[LANES]; //  ??? - nlg
+#if FASTLED_ERROR_DIFFUSION == 1
+        // error diffusion residuals: DIFFUSION_BITS per channel, packed into one uint16_t per pixel (lanes one after
+        // the other), indexed by data channel.  NULL unless the controller is using ERROR_DIFFUSION_DITHER.
+        uint16_t *mResidual = NULL;
+        uint8_t mResidualBits = 0;
+#endif
+#if FASTLED_OUTPUT_MAP == 1
+        // when set, the pixels are walked in the order of the map rather than the order of the data: the n'th pixel
+        // out (on each lane) is pixel mMap[n] counting from mBase (and bBase for the brightness array), and mData
+        // points at it.  NULL unless the controller has an output map.
+        const uint16_t *mMap = NULL;
+        const uint8_t *mBase = NULL;
+        const uint8_t *bBase = NULL;
+#endif
+#if FASTLED_POWER_FUSED == 1
+        // when set, the unscaled r, g and b values of the pixels walked are summed up in mPower, and added in to
+        // mPowerAccum (along with the number of pixels) once, when flushPower is called or this pixel controller
+        // goes away
+        uint32_t *mPowerAccum = NULL;
+        uint32_t mPower[3] = {0, 0, 0};
+
+        ~PixelController() { flushPower(); }
+
+        void flushPower() {
+            if(mPowerAccum) {
+                int nLanes = 0;
+                for(int i = 0; i < LANES; ++i) { if((1<<i) & MASK) { ++nLanes; } }
+                mPowerAccum[0] += mPower[0];
+                mPowerAccum[1] += mPower[1];
+                mPowerAccum[2] += mPower[2];
+                mPowerAccum[3] += (mLen - mLenRemaining) * nLanes;
+                mPowerAccum = NULL;
+            }
+        }
+#endif
 
         PixelController(const PixelController & other) {
             d[0] = other.d[0];
@@ -264,12 +686,25 @@ struct PixelController {
             e[1] = other.e[1];
             e[2] = other.e[2];
             mData = other.mData;
+            bData = other.bData;
             mScale = other.mScale;
             mAdvance = other.mAdvance;
             bAdvance = other.bAdvance;
             mLenRemaining = mLen = other.mLen;
             for(int i = 0; i < LANES; ++i) { mOffsets[i] = other.mOffsets[i]; }
-
+#if FASTLED_ERROR_DIFFUSION == 1
+            mResidual = other.mResidual;
+            mResidualBits = other.mResidualBits;
+#endif
+#if FASTLED_OUTPUT_MAP == 1
+            mMap = other.mMap;
+            mBase = other.mBase;
+            bBase = other.bBase;
+#endif
+#if FASTLED_POWER_FUSED == 1
+            mPowerAccum = other.mPowerAccum;
+            mPower[0] = mPower[1] = mPower[2] = 0;
+#endif
         }
 
         void initOffsets(int len) {
@@ -280,76 +715,76 @@ struct PixelController {
           }
         }
 
-        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const uint8_t *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER, bool advance=true, uint8_t skip=0) : mData(d), bData(NULL), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mData += skip;
             mAdvance = (advance) ? 3+skip : 0;
-            bAdvance = 0; // check - default - NLG
+            bAdvance = 0;
             initOffsets(len);
         }
 
-        // with brightness data - nlg
+        // with brightness data - PIXEL_RGB8_BRT
         PixelController(const CRGB *d, const uint8_t *b, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), bData(b), mLen(len), mLenRemaining(len), mScale(s) {
+            static_assert(Format::BRIGHTNESS == 1, "brightness array needs PIXEL_RGB8_BRT");
             enable_dithering(dither);
             mAdvance = 3;
-            bAdvance = sizeof(uint8_t);
+            bAdvance = 1;
+            initOffsets(len);
+        }
+
+        // with interleaved brightness data - PIXEL_RGB5B
+        PixelController(const CRGB5b *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), bData(NULL), mLen(len), mLenRemaining(len), mScale(s) {
+            static_assert(FORMAT == PIXEL_RGB5B, "CRGB5b data needs PIXEL_RGB5B");
+            enable_dithering(dither);
+            mAdvance = sizeof(CRGB5b);
+            bAdvance = 0;
             initOffsets(len);
         }
 
-        // with brightness data - nlg
-        PixelController(const CRGB5b *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mbData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s) {
+        // 16 bit per channel data - PIXEL_RGB16
+        PixelController(const CRGB16 *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), bData(NULL), mLen(len), mLenRemaining(len), mScale(s) {
+            static_assert(FORMAT == PIXEL_RGB16, "CRGB16 data needs PIXEL_RGB16");
             enable_dithering(dither);
-            mAdvance = 4;
+            mAdvance = sizeof(CRGB16);
+            bAdvance = 0;
             initOffsets(len);
         }
 
-        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB *d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)d), bData(NULL), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mAdvance = 3;
+            bAdvance = 0;
             initOffsets(len);
         }
 
-        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), mLen(len), mLenRemaining(len), mScale(s) {
+        PixelController(const CRGB &d, int len, CRGB & s, EDitherMode dither = BINARY_DITHER) : mData((const uint8_t*)&d), bData(NULL), mLen(len), mLenRemaining(len), mScale(s) {
             enable_dithering(dither);
             mAdvance = 0;
+            bAdvance = 0;
             initOffsets(len);
         }
 
+        // dithering for code that drives a PixelController directly: steps through a fixed VIRTUAL_BITS cycle, shared
+        // by every PixelController of this type.  Controllers use beginDithering, which follows each one's frame rate.
         void init_binary_dithering() {
 #if !defined(NO_DITHERING) || (NO_DITHERING != 1)
-
-            // Set 'virtual bits' of dithering to the highest level
-            // that is not likely to cause excessive flickering at
-            // low brightness levels + low update rates.
-            // These pre-set values are a little ambitious, since
-            // a 400Hz update rate for WS2811-family LEDs is only
-            // possible with 85 pixels or fewer.
-            // Once we have a 'number of milliseconds since last update'
-            // value available here, we can quickly calculate the correct
-            // number of 'virtual bits' on the fly with a couple of 'if'
-            // statements -- no division required.  At this point,
-            // the division is done at compile time, so there's no runtime
-            // cost, but the values are still hard-coded.
-#define MAX_LIKELY_UPDATE_RATE_HZ     400
-#define MIN_ACCEPTABLE_DITHER_RATE_HZ  50
-#define UPDATES_PER_FULL_DITHER_CYCLE (MAX_LIKELY_UPDATE_RATE_HZ / MIN_ACCEPTABLE_DITHER_RATE_HZ)
-#define RECOMMENDED_VIRTUAL_BITS ((UPDATES_PER_FULL_DITHER_CYCLE>1) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>2) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>4) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>8) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>16) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>32) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>64) + \
-                                  (UPDATES_PER_FULL_DITHER_CYCLE>128) )
-#define VIRTUAL_BITS RECOMMENDED_VIRTUAL_BITS
-
-            // R is the digther signal 'counter'.
+            // R is the dither signal 'counter'.
             static uint8_t R = 0;
             ++R;
+            init_binary_dithering(R, VIRTUAL_BITS);
+#endif
+        }
+
+        // set up dithering for step R of a cycle of 2^ditherBits frames.  0 bits turns dithering off.
+        void init_binary_dithering(uint8_t R, uint8_t ditherBits) {
+#if !defined(NO_DITHERING) || (NO_DITHERING != 1)
+            if(ditherBits == 0) {
+                d[0] = d[1] = d[2] = e[0] = e[1] = e[2] = 0;
+                return;
+            }
 
             // R is wrapped around at 2^ditherBits,
             // so if ditherBits is 2, R will cycle through (0,1,2,3)
-            uint8_t ditherBits = VIRTUAL_BITS;
             R &= (0x01 << ditherBits) - 1;
 
             // Q is the "unscaled dither signal" itself.
@@ -394,6 +829,26 @@ struct PixelController {
 #endif
         }
 
+#if FASTLED_OUTPUT_MAP == 1
+        // walk the data in the order of map, from the first pixel, with the data pointers and direction as they are now
+        void setMap(const uint16_t *map) {
+            mMap = map;
+            mBase = mData;
+            bBase = bData;
+            mLenRemaining = mLen;
+            gather();
+        }
+
+        // point the data at the pixel that goes out next.  Past the last pixel the data is left where it is, so output
+        // code that loads a pixel beyond the end still reads inside the data.
+        __attribute__((always_inline)) inline void gather() {
+            if(mLenRemaining <= 0) { return; }
+            int n = mMap[mLen - mLenRemaining];
+            mData = mBase + (n * mAdvance);
+            if(Format::BRIGHTNESS == 1) { bData = bBase + (n * bAdvance); }
+        }
+#endif
+
         // Do we have n pixels left to process?
         __attribute__((always_inline)) inline bool has(int n) {
             return mLenRemaining >= n;
@@ -412,11 +867,45 @@ struct PixelController {
         // get the amount to advance the pointer by
         __attribute__((always_inline)) inline int advanceBy() { return mAdvance; }
 
-        // advance the data pointer forward, adjust position counter
-        //  __attribute__((always_inline)) inline void advanceData() { mData += mAdvance; --mLenRemaining;}
-        // bAdvance may be 0, besides for APA102WB
-        //  __attribute__((always_inline)) inline void advanceData() { mData += mAdvance; bData += bAdvance; --mLenRemaining;}
-         __attribute__((always_inline)) inline void advanceData() { mData += mAdvance; bData += bAdvance; mbData += mAdvance+bAdvance; --mLenRemaining;}
+        // advance the data pointer forward, adjust position counter.  The brightness array is only walked when the
+        // format has one, so the other formats pay nothing for it.
+         __attribute__((always_inline)) inline void advanceData() {
+#if FASTLED_POWER_FUSED == 1
+            if(mPowerAccum) { accumulatePower(); }
+#endif
+#if FASTLED_OUTPUT_MAP == 1
+            if(mMap) {
+                --mLenRemaining;
+                gather();
+                return;
+            }
+#endif
+            mData += mAdvance;
+            if(Format::BRIGHTNESS == 1) { bData += bAdvance; }
+            --mLenRemaining;
+        }
+
+#if FASTLED_POWER_FUSED == 1
+        // add the current pixel (of every lane that's in use) to the power totals.  The raw, unscaled values are
+        // summed, the same as calculate_unscaled_power_mW does, weighted by the 5 bit brightness when there is one.
+        __attribute__((always_inline)) inline void accumulatePower() {
+            for(int i = 0; i < LANES; ++i) {
+                if(!((1<<i) & MASK)) { continue; }
+                // lane 0 always starts at offset 0
+                const uint8_t *p = mData + (i ? mOffsets[i] : 0) + (Format::CHANNEL_BYTES - 1);
+                if(Format::BRIGHTNESS) {
+                    uint8_t brt = loadBrightness();
+                    mPower[0] += p[0] * brt;
+                    mPower[1] += p[Format::CHANNEL_BYTES] * brt;
+                    mPower[2] += p[2 * Format::CHANNEL_BYTES] * brt;
+                } else {
+                    mPower[0] += p[0];
+                    mPower[1] += p[Format::CHANNEL_BYTES];
+                    mPower[2] += p[2 * Format::CHANNEL_BYTES];
+                }
+            }
+        }
+#endif
 
         // step the dithering forward
          __attribute__((always_inline)) inline void stepDithering() {
@@ -432,13 +921,19 @@ struct PixelController {
             d[RO(0)] = e[RO(0)] - d[RO(0)];
         }
 
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadByte(PixelController & pc) { return pc.mData[RO(SLOT)]; }
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadByte(PixelController & pc, int lane) { return pc.mData[pc.mOffsets[lane] + RO(SLOT)]; }
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadByteWB(PixelController & pc, int lane) { return pc.mbData[pc.mbOffsets[lane] + RO5b(SLOT)]; }
+        // offset of the (high) byte of channel SLOT within a pixel
+        template<int SLOT>  __attribute__((always_inline)) inline static int channelOffset() { return (RO(SLOT) * Format::CHANNEL_BYTES) + (Format::CHANNEL_BYTES - 1); }
+
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadByte(PixelController & pc) { return pc.mData[channelOffset<SLOT>()]; }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadByte(PixelController & pc, int lane) { return pc.mData[pc.mOffsets[lane] + channelOffset<SLOT>()]; }
 
-        // Only works with bdata, not mbdata - TODO cleanup - nlg
-        __attribute__((always_inline)) inline uint8_t get5bitBright(PixelController & pc) { return pc.bData[0]; }
-        __attribute__((always_inline)) inline uint8_t get5bitBright() { return get5bitBright(*this); }
+        // the 5 bit brightness of the current pixel, full brightness for formats that don't carry one
+        __attribute__((always_inline)) inline static uint8_t loadBrightness(PixelController & pc) {
+            if(Format::BRIGHTNESS == 1) { return pc.bData[0] & 0x1F; }
+            if(Format::BRIGHTNESS == 2) { return pc.mData[3] & 0x1F; }
+            return 0x1F;
+        }
+        __attribute__((always_inline)) inline uint8_t loadBrightness() { return loadBrightness(*this); }
 
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t dither(PixelController & pc, uint8_t b) { return b ? qadd8(b, pc.d[RO(SLOT)]) : 0; }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t dither(PixelController & , uint8_t b, uint8_t d) { return b ? qadd8(b,d) : 0; }
@@ -446,13 +941,47 @@ struct PixelController {
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t scale(PixelController & pc, uint8_t b) { return scale8(b, pc.mScale.raw[RO(SLOT)]); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t scale(PixelController & , uint8_t b, uint8_t scale) { return scale8(b, scale); }
 
+#if FASTLED_ERROR_DIFFUSION == 1
+        // error diffusion: scale channel SLOT of the current pixel on lane, adding in the residual left over from the
+        // last frame, and keep what's lost to rounding this time for the next one.  16 bit data keeps its low byte.
+        template<int SLOT> __attribute__((noinline)) static uint8_t diffuse(PixelController & pc, int lane, uint8_t scale) {
+            static_assert(3 * DIFFUSION_BITS <= 16, "the residuals of all three channels must fit in 16 bits");
+            const uint8_t *p = pc.mData + pc.mOffsets[lane] + channelOffset<SLOT>();
+            uint16_t v = (Format::CHANNEL_BYTES == 2) ? ((p[0] << 8) | p[-1]) : (p[0] << 8);
+            uint16_t & res = pc.mResidual[(lane * pc.mLen) + (pc.mLen - pc.mLenRemaining)];
+            const uint8_t shift = RO(SLOT) * DIFFUSION_BITS;
+            const uint8_t mask = (1 << pc.mResidualBits) - 1;
+            if(!v || !scale) {
+                res &= ~(((1 << DIFFUSION_BITS) - 1) << shift);
+                return 0;
+            }
+#if (FASTLED_SCALE8_FIXED == 1)
+            uint16_t t = ((uint32_t)v * (scale + 1)) >> 8;
+#else
+            uint16_t t = ((uint32_t)v * scale) >> 8;
+#endif
+            // t rounded to the nearest 1/2^mResidualBits
+            uint32_t q = ((uint32_t)t + (0x80 >> pc.mResidualBits)) >> (8 - pc.mResidualBits);
+            uint8_t acc = ((res >> shift) & mask) + (q & mask);
+            res = (res & ~(((1 << DIFFUSION_BITS) - 1) << shift)) | ((acc & mask) << shift);
+            uint16_t out = (q >> pc.mResidualBits) + (acc >> pc.mResidualBits);
+            return out > 255 ? 255 : out;
+        }
+
+        // composite shortcut functions for loading, dithering, and scaling
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) { return pc.mResidual ? diffuse<SLOT>(pc, 0, pc.mScale.raw[RO(SLOT)]) : scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) { return pc.mResidual ? diffuse<SLOT>(pc, lane, pc.mScale.raw[RO(SLOT)]) : scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane))); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t d, uint8_t scale) { return pc.mResidual ? diffuse<SLOT>(pc, lane, scale) : scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), d), scale); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) { return pc.mResidual ? diffuse<SLOT>(pc, lane, scale) : scale8(pc.loadByte<SLOT>(pc, lane), scale); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadDitherAndScale(PixelController & pc, int lane, uint8_t scale) { return pc.mResidual ? diffuse<SLOT>(pc, lane, scale) : scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane)), scale); }
+#else
         // composite shortcut functions for loading, dithering, and scaling
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc))); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane) { return scale<SLOT>(pc, pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane))); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t d, uint8_t scale) { return scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane), d), scale); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScale(PixelController & pc, int lane, uint8_t scale) { return scale8(pc.loadByte<SLOT>(pc, lane), scale); }
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadAndScaleWB(PixelController & pc, int lane, uint8_t scale) { return scale8(pc.loadByteWB<SLOT>(pc, lane), scale); }
-        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadWB(PixelController & pc, int lane) { return pc.loadByteWB<SLOT>(pc, lane); }
+        template<int SLOT>  __attribute__((always_inline)) inline static uint8_t loadDitherAndScale(PixelController & pc, int lane, uint8_t scale) { return scale8(pc.dither<SLOT>(pc, pc.loadByte<SLOT>(pc, lane)), scale); }
+#endif
 
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t advanceAndLoadAndScale(PixelController & pc) { pc.advanceData(); return pc.loadAndScale<SLOT>(pc); }
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t advanceAndLoadAndScale(PixelController & pc, int lane) { pc.advanceData(); return pc.loadAndScale<SLOT>(pc, lane); }
@@ -462,17 +991,13 @@ struct PixelController {
         template<int SLOT>  __attribute__((always_inline)) inline static uint8_t getscale(PixelController & pc) { return pc.mScale.raw[RO(SLOT)]; }
 
         // Helper functions to get around gcc stupidities
-        __attribute__((always_inline)) inline uint8_t loadWB0(int lane) { return loadWB<0>(*this, lane); }
-        __attribute__((always_inline)) inline uint8_t loadWB1(int lane) { return loadWB<1>(*this, lane); }
-        __attribute__((always_inline)) inline uint8_t loadWB2(int lane) { return loadWB<2>(*this, lane); }
-        __attribute__((always_inline)) inline uint8_t loadWB3(int lane) { return loadWB<3>(*this, lane); } // 5bit bright - nlg
         __attribute__((always_inline)) inline uint8_t loadAndScale0(int lane, uint8_t scale) { return loadAndScale<0>(*this, lane, scale); }
         __attribute__((always_inline)) inline uint8_t loadAndScale1(int lane, uint8_t scale) { return loadAndScale<1>(*this, lane, scale); }
         __attribute__((always_inline)) inline uint8_t loadAndScale2(int lane, uint8_t scale) { return loadAndScale<2>(*this, lane, scale); }
-        __attribute__((always_inline)) inline uint8_t loadAndScaleWB0(int lane, uint8_t scale) { return loadAndScaleWB<0>(*this, lane, scale); }
-        __attribute__((always_inline)) inline uint8_t loadAndScaleWB1(int lane, uint8_t scale) { return loadAndScaleWB<1>(*this, lane, scale); }
-        __attribute__((always_inline)) inline uint8_t loadAndScaleWB2(int lane, uint8_t scale) { return loadAndScaleWB<2>(*this, lane, scale); }
-        __attribute__((always_inline)) inline uint8_t loadAndScaleWB3(int lane, uint8_t scale) { return loadAndScaleWB<3>(*this, lane, scale); } // 5bit bright - nlg
+        // dithered, unlike loadAndScaleN(lane, scale)
+        __attribute__((always_inline)) inline uint8_t loadDitherAndScale0(int lane, uint8_t scale) { return loadDitherAndScale<0>(*this, lane, scale); }
+        __attribute__((always_inline)) inline uint8_t loadDitherAndScale1(int lane, uint8_t scale) { return loadDitherAndScale<1>(*this, lane, scale); }
+        __attribute__((always_inline)) inline uint8_t loadDitherAndScale2(int lane, uint8_t scale) { return loadDitherAndScale<2>(*this, lane, scale); }
         __attribute__((always_inline)) inline uint8_t advanceAndLoadAndScale0(int lane, uint8_t scale) { return advanceAndLoadAndScale<0>(*this, lane, scale); }
         __attribute__((always_inline)) inline uint8_t stepAdvanceAndLoadAndScale0(int lane, uint8_t scale) { stepDithering(); return advanceAndLoadAndScale<0>(*this, lane, scale); }
 
@@ -502,8 +1027,52 @@ protected:
     ///@param nLeds the numner of leds to set to this color
     ///@param scale the rgb scaling value for outputting color
     virtual void showColor(const struct CRGB & data, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
+        beginPowerAccounting(pixels);
+        showPixels(pixels);
+        endPowerAccounting(pixels);
+    }
+
+    /// write the passed in rgb data out to the leds managed by this controller
+    ///@param data the rgb data to write out to the strip
+    ///@param nLeds the number of leds being written out
+    ///@param scale the rgb scaling to apply to each led before writing it out
+    virtual void show(const struct CRGB *data, int nLeds, CRGB scale) {
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
+        if(nLeds < 0) {
+            // nLeds < 0 implies that we want to show them in reverse
+            pixels.mAdvance = -pixels.mAdvance;
+        }
+        beginOutputMap(pixels);
+        beginPowerAccounting(pixels);
+        showPixels(pixels);
+        endPowerAccounting(pixels);
+    }
+
+public:
+    CPixelLEDController() : CLEDController() {}
+};
+
+/// Pixel controller base for chipsets with a per pixel brightness field.  Subclasses implement showPixels for each
+/// of the PIXEL_RGB8, PIXEL_RGB8_BRT and PIXEL_RGB5B formats.
+template<EOrder RGB_ORDER, int LANES=1, uint32_t MASK=0xFFFFFFFF> class CPixelBrightnessLEDController : public CBrightnessLEDController {
+protected:
+    virtual void showPixels(PixelController<RGB_ORDER,LANES,MASK> & pixels) = 0;
+    virtual void showPixels(PixelController<RGB_ORDER,LANES,MASK,PIXEL_RGB8_BRT> & pixels) = 0;
+    virtual void showPixels(PixelController<RGB_ORDER,LANES,MASK,PIXEL_RGB5B> & pixels) = 0;
+
+    /// set all the leds on the controller to a given color
+    ///@param data the crgb color to set the leds to
+    ///@param nLeds the numner of leds to set to this color
+    ///@param scale the rgb scaling value for outputting color
+    virtual void showColor(const struct CRGB & data, int nLeds, CRGB scale) {
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
+        beginPowerAccounting(pixels);
         showPixels(pixels);
+        endPowerAccounting(pixels);
     }
 
     /// write the passed in rgb data out to the leds managed by this controller
@@ -511,25 +1080,35 @@ protected:
     ///@param nLeds the number of leds being written out
     ///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
         if(nLeds < 0) {
             // nLeds < 0 implies that we want to show them in reverse
             pixels.mAdvance = -pixels.mAdvance;
         }
+        beginOutputMap(pixels);
+        beginPowerAccounting(pixels);
         showPixels(pixels);
+        endPowerAccounting(pixels);
     }
 
     /// write the passed in rgb data out to the leds managed by this controller
     ///@param data the rgb data to write out to the strip
+    ///@param bdata the brightness data to write out to the strip (0-31)
     ///@param nLeds the number of leds being written out
     ///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB *data, uint8_t *bdata, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, bdata, nLeds < 0 ? -nLeds : nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK, PIXEL_RGB8_BRT> pixels(data, bdata, nLeds < 0 ? -nLeds : nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
         if(nLeds < 0) {
             // nLeds < 0 implies that we want to show them in reverse
             pixels.mAdvance = -pixels.mAdvance;
+            pixels.bAdvance = -pixels.bAdvance;
         }
+        beginOutputMap(pixels);
+        beginPowerAccounting(pixels);
         showPixels(pixels);
+        endPowerAccounting(pixels);
     }
 
     /// write the passed in rgb data out to the leds managed by this controller
@@ -537,20 +1116,22 @@ protected:
     ///@param nLeds the number of leds being written out
     ///@param scale the rgb scaling to apply to each led before writing it out
     virtual void show(const struct CRGB5b *data, int nLeds, CRGB scale) {
-        PixelController<RGB_ORDER, LANES, MASK> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, getDither());
+        PixelController<RGB_ORDER, LANES, MASK, PIXEL_RGB5B> pixels(data, nLeds < 0 ? -nLeds : nLeds, scale, DISABLE_DITHER);
+        beginDithering(pixels);
         if(nLeds < 0) {
             // nLeds < 0 implies that we want to show them in reverse
             pixels.mAdvance = -pixels.mAdvance;
-            // pixels.mbAdvance = -pixels.mbAdvance;
         }
+        beginOutputMap(pixels);
+        beginPowerAccounting(pixels);
         showPixels(pixels);
+        endPowerAccounting(pixels);
     }
 
 public:
-    CPixelLEDController() : CLEDController() {}
+    CPixelBrightnessLEDController() : CBrightnessLEDController() {}
 };
 
-
 FASTLED_NAMESPACE_END
 
 #endif
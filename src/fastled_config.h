@@ -34,8 +34,10 @@
 // fix is enabled by default.  However, if for some reason you have code that is not
 // working right as a result of this (e.g. code that was expecting the old scale8 behavior)
 // you can disable it here.
+#ifndef FASTLED_SCALE8_FIXED
 #define FASTLED_SCALE8_FIXED 1
 // #define FASTLED_SCALE8_FIXED 0
+#endif
 
 // Use this toggle whether to use 'fixed' FastLED pixel blending, including ColorFromPalette.
 // The prior pixel blend functions had integer-rounding math errors that led to
@@ -43,8 +45,10 @@
 // retrieved from color palettes using LINEAR_BLEND.  This is now fixed, and the
 // fix is enabled by default.  However, if for some reason you wish to run with the old
 // blending, including the integer rounding and color errors, you can disable the bugfix here.
+#ifndef FASTLED_BLEND_FIXED
 #define FASTLED_BLEND_FIXED 1
 // #define FASTLED_BLEND_FIXED 0
+#endif
 
 // Use this toggle whether to use 'fixed' FastLED 8- and 16-bit noise functions.
 // The prior noise functions had some math errors that led to 'discontinuities' in the
@@ -66,4 +70,52 @@
 // This enable much more accurate color control on low brightness settings.
 //#define FASTLED_USE_GLOBAL_BRIGHTNESS 1
 
+// Use this toggle to have the APA102 and SK9822 controllers encode the whole frame into a wire format buffer
+// and send it with a single writeBytes call, instead of writing each led out as it is scaled.  Costs 4 bytes
+// of ram per led (plus the start and end frames), allocated the first time the controller shows.
+//#define FASTLED_APA102_FRAME_BUFFER 1
+
+// Use this toggle to have the power limiting use color totals summed up while each controller writes out its
+// frame, instead of making a separate pass over all of the led data before every show.  The brightness limit
+// then lags one frame behind the led data.  Adds a little work per led to the output loops, and controllers
+// whose output code doesn't go through PixelController::advanceData (e.g. the AVR clockless asm) still get the
+// separate pass.
+//#define FASTLED_POWER_FUSED 1
+
+// Use this toggle to have FastLED.show skip controllers whose led data, brightness, color correction and dithering
+// are all unchanged since the last frame they wrote out.  Costs a hash over each controller's led data per show.
+// Controllers with dithering on are always written out, since the dithering changes the output from frame to frame.
+// Drivers that send all of their strips at once (the ESP32 RMT and I2S drivers) only skip when all of them are unchanged.
+// FastLED.setKeepAlive sets how often unchanged controllers are written out anyway, and FastLED.getSkippedFrames
+// counts the ones that were skipped.
+//#define FASTLED_SKIP_UNCHANGED 1
+
+// Use this toggle to let controllers take an output map (CLEDController::setOutputMap), so that leds drawn in
+// logical order are written out in wire order, gathered from the led data as each frame is encoded, with no
+// permuting copy before show.  Adds a little work per led to the output loops.  Output code that reads the led data
+// in place (the AVR and Cortex-M0 clockless asm, SmartMatrix) doesn't see the map.
+//#define FASTLED_OUTPUT_MAP 1
+
+// Use this toggle to collect frame timing statistics: time spent encoding, transmitting, waiting for leds to latch
+// and throttling to the max refresh rate, interrupt retries, and a histogram of frame intervals.  Read them with
+// FastLED.getStats() and CLEDController::getStats() (see fastled_stats.h).  Adds a few calls to micros() per
+// controller per frame.
+//#define FASTLED_STATS 1
+
+// Use this toggle to have each controller size its temporal dithering from its own measured frame interval, so that
+// a strip refreshed at 400Hz gets 3 bits of dithering and one refreshed at 100Hz gets 1, instead of all of them using
+// VIRTUAL_BITS bits, with dithering turned off while FastLED.show runs at under 100fps.  Adds 9 bytes of ram and a
+// call to micros() per controller per frame.
+//#define FASTLED_ADAPTIVE_DITHER 1
+
+// Use this toggle to make setDither(ERROR_DIFFUSION_DITHER) available: each pixel carries what was lost to rounding
+// into the next frame.  Adds 6 bytes of ram per controller, plus 2 bytes per led for the controllers that use it, and
+// a check per channel to the output loops.  Without it, ERROR_DIFFUSION_DITHER is the same as BINARY_DITHER.
+//#define FASTLED_ERROR_DIFFUSION 1
+
+// Use this toggle to let controllers take their led data from a triple buffer (CLEDController::setLeds(CFrameBuffer&),
+// see frame_buffer.h), so that frames can be drawn on one core or thread and shown from another.  Adds a pointer to
+// each controller, and a check per controller to FastLED.show.
+//#define FASTLED_TRIPLE_BUFFER 1
+
 #endif
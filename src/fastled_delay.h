@@ -20,10 +20,14 @@ public:
 	CMinWait() { mLastMicros = 0; }
 
 	void wait() {
+#if FASTLED_STATS == 1
+		uint32_t start = micros();
+#endif
 		uint16_t diff;
 		do {
 			diff = (micros() & 0xFFFF) - mLastMicros;
 		} while(diff < WAIT);
+		FASTLED_STAT_ADD(waitMicros, micros() - start);
 	}
 
 	void mark() { mLastMicros = micros() & 0xFFFF; }
@@ -0,0 +1,68 @@
+#ifndef __INC_FASTLED_STATS_H
+#define __INC_FASTLED_STATS_H
+
+///@file fastled_stats.h
+/// Frame timing statistics, collected when FASTLED_STATS is set (see fastled_config.h).  Read them with
+/// FastLED.getStats() and CLEDController::getStats().  All times are in microseconds.  The counters wrap around, so
+/// to follow them over long periods take the difference between two reads, or call FastLED.resetStats() after each read.
+
+FASTLED_NAMESPACE_BEGIN
+
+#if FASTLED_STATS == 1
+
+/// number of buckets in the frame interval histogram
+#define FASTLED_STATS_BUCKETS 8
+
+/// Statistics for one led controller
+struct CLEDStats {
+	uint32_t frames;          ///< frames written out
+	uint32_t encodeMicros;    ///< time spent converting led data to its wire format before sending it.  Only output
+	                          ///< code that does this as a separate step (e.g. the APA102 frame buffer) reports it,
+	                          ///< the rest encodes as it transmits and counts it all as transmitMicros
+	uint32_t transmitMicros;  ///< time spent writing frames out, not counting encodeMicros and waitMicros.  For output
+	                          ///< that runs in the background (showAsync), just the time taken to start it
+	uint32_t waitMicros;      ///< time spent in CMinWait::wait, waiting for the leds to latch the previous frame
+	uint32_t retries;         ///< frames restarted because an interrupt held up the output for too long (see
+	                          ///< FASTLED_INTERRUPT_RETRY_COUNT)
+};
+
+/// Statistics for FastLED.show, showColor and showAsync
+struct CFastLEDStats {
+	uint32_t frames;          ///< frames shown
+	uint32_t showMicros;      ///< time spent in show, including throttleMicros
+	uint32_t throttleMicros;  ///< time spent waiting to stay under the maximum refresh rate (setMaxRefreshRate)
+	uint32_t lateFrames;      ///< frames shown after they were due at the maximum refresh rate (see getFrameSlack)
+	uint32_t intervals;       ///< number of frame intervals measured (frames after the first)
+	uint32_t minFrameMicros;  ///< shortest time from the start of one frame to the start of the next
+	uint32_t maxFrameMicros;  ///< longest time from the start of one frame to the start of the next
+	uint32_t totalFrameMicros;///< total of the frame intervals
+	/// frame intervals: bucket 0 counts those under 1ms, bucket n those from 2^(n-1)ms up to 2^n ms, and the last
+	/// bucket everything longer
+	uint32_t histogram[FASTLED_STATS_BUCKETS];
+
+	/// average time between frames
+	uint32_t avgFrameMicros() const { return intervals ? totalFrameMicros / intervals : 0; }
+};
+
+#if defined(FASTLED_HAS_SHOW_POOL)
+// controllers can be shown from several threads at once (see FastLED.setShowWorkers)
+#define FASTLED_STATS_THREAD_LOCAL thread_local
+#else
+#define FASTLED_STATS_THREAD_LOCAL
+#endif
+
+/// stats of the controller currently being shown, for the output code to add to.  NULL outside of a show.
+extern FASTLED_STATS_THREAD_LOCAL CLEDStats *gActiveStats;
+
+/// add N to FIELD of the stats of the controller being shown
+#define FASTLED_STAT_ADD(FIELD, N) do { if(gActiveStats) { gActiveStats->FIELD += (N); } } while(0)
+
+#else
+
+#define FASTLED_STAT_ADD(FIELD, N)
+
+#endif
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -10,16 +10,21 @@
 
 FASTLED_NAMESPACE_BEGIN
 
+// SPI_WIRE_MICROS(SPEED, BITS) is the time, in microseconds, that BITS bits take on the wire at a SPEED given with
+// DATA_RATE_MHZ/DATA_RATE_KHZ.  Output that can't clock out as fast as asked for (e.g. bit banged) takes longer.
 #if defined(FASTLED_TEENSY3) && (F_CPU > 48000000)
 #define DATA_RATE_MHZ(X) (((48000000L / 1000000L) / X))
 #define DATA_RATE_KHZ(X) (((48000000L / 1000L) / X))
+#define SPI_WIRE_MICROS(SPEED, BITS) (((uint32_t)(BITS) * (SPEED)) / (48000000L / 1000000L))
 #elif defined(FASTLED_TEENSY4) || (defined(ESP32) && defined(FASTLED_ALL_PINS_HARDWARE_SPI)) || (defined(ESP8266) && defined(FASTLED_ALL_PINS_HARDWARE_SPI))
 // just use clocks
 #define DATA_RATE_MHZ(X) (1000000 * (X))
 #define DATA_RATE_KHZ(X) (1000 * (X))
+#define SPI_WIRE_MICROS(SPEED, BITS) (((uint32_t)(BITS) * 1000) / ((SPEED) / 1000))
 #else
 #define DATA_RATE_MHZ(X) ((F_CPU / 1000000L) / X)
 #define DATA_RATE_KHZ(X) ((F_CPU / 1000L) / X)
+#define SPI_WIRE_MICROS(SPEED, BITS) (((uint32_t)(BITS) * (SPEED)) / (F_CPU / 1000000L))
 #endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -64,6 +69,11 @@ template<uint8_t _DATA_PIN, uint8_t _CLOCK_PIN, uint32_t _SPI_CLOCK_DIVIDER>
 class SPIOutput : public ESP8266SPIOutput<_DATA_PIN, _CLOCK_PIN, _SPI_CLOCK_DIVIDER> {};
 #endif
 
+#if defined(FASTLED_HOST) && defined(FASTLED_ALL_PINS_HARDWARE_SPI)
+template<uint8_t _DATA_PIN, uint8_t _CLOCK_PIN, uint32_t _SPI_CLOCK_DIVIDER>
+class SPIOutput : public HostSPIOutput<_DATA_PIN, _CLOCK_PIN, _SPI_CLOCK_DIVIDER> {};
+#endif
+
 #if defined(SPI_DATA) && defined(SPI_CLOCK)
 
 #if defined(FASTLED_TEENSY3) && defined(ARM_HARDWARE_SPI)
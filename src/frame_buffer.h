@@ -0,0 +1,135 @@
+#ifndef __INC_FRAME_BUFFER_H
+#define __INC_FRAME_BUFFER_H
+
+#include "FastLED.h"
+
+///@file frame_buffer.h
+/// Triple buffered led data, for handing frames from the code that draws them to the code that shows them when the
+/// two run in different contexts (another core, a thread, an interrupt).  The drawing side gets a back buffer of
+/// its own to draw into and publishes it when the frame is complete; the showing side always takes the newest
+/// complete frame.  Neither side ever waits for the other, and frames are handed over by swapping buffer indices,
+/// never by copying led data.
+///
+/// Typical use, with the leds drawn on one core and FastLED.show called on the other:
+///
+///     CFrameBuffer<CRGB, NUM_LEDS> frames;
+///     FastLED.addLeds<WS2812B, DATA_PIN, GRB>(frames.front(), NUM_LEDS).setLeds(frames);
+///
+///     // drawing side
+///     fill_rainbow(frames.back(), NUM_LEDS, hue++);
+///     frames.publish();
+///
+///     // showing side - each show takes the newest published frame, or shows the last one again if there isn't one
+///     FastLED.show();
+///
+/// After publish, back() is a different buffer holding an older frame, so draw the whole frame each time rather
+/// than changing the last one.  Don't write to the back buffer from the showing side, or to front() from the
+/// drawing side.  Controllers only take their led data from a frame buffer with FASTLED_TRIPLE_BUFFER set
+/// (see fastled_config.h).
+
+FASTLED_NAMESPACE_BEGIN
+
+/// The part of a frame buffer that doesn't depend on the type of led data: which of the three buffers belongs to
+/// which side, and where the buffers are.  Controllers take their led data from one of these (see
+/// CLEDController::setLeds).
+class CFrameSource {
+	// the middle buffer, the one that is neither drawn into nor shown, is shared between the two sides: bits 0-1 hold
+	// its index, and FRESH is set when it holds a frame published since the showing side last took one.  Both sides
+	// only ever exchange their own buffer for it, so each buffer always has exactly one owner.
+	enum { INDEX = 0x03, FRESH = 0x04 };
+	int mShared;
+	uint8_t mBack;      // drawn into, owned by the drawing side
+	uint8_t mFront;     // being shown, owned by the showing side
+	uint8_t mPixelBytes;
+	int mLeds;
+	uint8_t *mPixels;   // three frames of mLeds + 1 pixels, one after another
+	uint8_t *mBrightness; // three frames of mLeds + 1 per pixel brightness values, or NULL
+
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+	uint8_t exchange(uint8_t value) { return (uint8_t)__atomic_exchange_n(&mShared, (int)value, __ATOMIC_ACQ_REL); }
+	bool fresh() const { return (__atomic_load_n(&mShared, __ATOMIC_RELAXED) & FRESH) != 0; }
+#else
+	// no atomic exchange on this chip: a single core one, where keeping interrupts out makes the swap atomic.  The
+	// interrupt state is put back the way it was afterwards, so either side can run in an interrupt handler.
+	uint8_t exchange(uint8_t value) {
+#if defined(__AVR__)
+		uint8_t sreg = SREG;
+		cli();
+		uint8_t old = (uint8_t)mShared;
+		mShared = value;
+		SREG = sreg;
+#elif defined(__arm__)
+		uint32_t primask;
+		__asm__ __volatile__("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+		uint8_t old = (uint8_t)mShared;
+		mShared = value;
+		__asm__ __volatile__("msr primask, %0" : : "r" (primask) : "memory");
+#else
+		// nothing to save the interrupt state with here, so this can't be called from an interrupt handler
+		cli();
+		uint8_t old = (uint8_t)mShared;
+		mShared = value;
+		sei();
+#endif
+		return old;
+	}
+	bool fresh() const { return (*(volatile const int *)&mShared & FRESH) != 0; }
+#endif
+
+protected:
+	CFrameSource(uint8_t *pixels, uint8_t *brightness, int nLeds, uint8_t pixelBytes)
+		: mShared(1), mBack(0), mFront(2), mPixelBytes(pixelBytes), mLeds(nLeds), mPixels(pixels), mBrightness(brightness) {}
+
+	// output code reads the first pixel past the end of the data it's given (and throws it away), so each frame is
+	// followed by a spare pixel, keeping those reads out of the next frame, which the other side may be writing
+	uint8_t *pixels(uint8_t index) const { return mPixels + (index * (mLeds + 1) * mPixelBytes); }
+	uint8_t *brightness(uint8_t index) const { return mBrightness ? (mBrightness + (index * (mLeds + 1))) : NULL; }
+
+public:
+	/// number of leds in each frame
+	int size() const { return mLeds; }
+	/// size of one led's data: 3 for CRGB, 4 for CRGB5b
+	uint8_t pixelBytes() const { return mPixelBytes; }
+
+	/// drawing side: hand the back buffer over as the newest complete frame, and take a new back buffer to draw the
+	/// next one into.  A published frame that was never shown is drawn over.
+	void publish() { mBack = exchange(mBack | FRESH) & INDEX; }
+
+	/// showing side: switch front() to the newest published frame.  Returns false, leaving front() as it was, if
+	/// nothing has been published since the last call.
+	bool acquire() {
+		if(!fresh()) { return false; }
+		mFront = exchange(mFront) & INDEX;
+		return true;
+	}
+
+	/// showing side: the frame being shown, and its per pixel brightness (NULL if there isn't any)
+	uint8_t *frontPixels() const { return pixels(mFront); }
+	uint8_t *frontBrightness() const { return brightness(mFront); }
+	/// drawing side: the frame being drawn, and its per pixel brightness (NULL if there isn't any)
+	uint8_t *backPixels() const { return pixels(mBack); }
+	uint8_t *backBrightness() const { return brightness(mBack); }
+};
+
+/// Three frames of SIZE leds of PIXEL (CRGB or CRGB5b) data, with a 5 bit per pixel brightness array alongside each
+/// frame when BRIGHTNESS is set.  See the top of this file for how it's used.
+template<class PIXEL, int SIZE, bool BRIGHTNESS = false>
+class CFrameBuffer : public CFrameSource {
+	PIXEL mFrames[3][SIZE + 1];
+	uint8_t mBrightnessFrames[BRIGHTNESS ? 3 : 1][BRIGHTNESS ? (SIZE + 1) : 1];
+
+public:
+	CFrameBuffer() : CFrameSource((uint8_t*)mFrames, BRIGHTNESS ? &mBrightnessFrames[0][0] : NULL, SIZE, sizeof(PIXEL)) {
+		memset8((void*)mFrames, 0, sizeof(mFrames));
+		memset8((void*)mBrightnessFrames, 0, sizeof(mBrightnessFrames));
+	}
+
+	/// drawing side: the leds of the frame being drawn
+	PIXEL *back() const { return (PIXEL*)backPixels(); }
+	/// showing side: the leds of the frame being shown
+	PIXEL *front() const { return (PIXEL*)frontPixels(); }
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
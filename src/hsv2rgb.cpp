@@ -1,8 +1,19 @@
 #define FASTLED_INTERNAL
 #include <stdint.h>
+#include <string.h>
 
 #include "FastLED.h"
 
+// vector registers for the batch conversions, see hsv2rgb_rainbow( const CHSV*, CRGB*, int)
+#if defined(__AVR__)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define HSV2RGB_LANES 16
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HSV2RGB_LANES 8
+#endif
+
 FASTLED_NAMESPACE_BEGIN
 
 // Functions to convert HSV colors to RGB colors.
@@ -497,6 +508,12 @@ void hsv2rgb_rainbow( const CHSV& hsv, CRGB& rgb)
 }
 
 
+// Batch conversion.  Outside of AVR, runs of pixels are converted without branching on the hue section: 8 or 16 at
+// a time in vector registers where there are any (SSE2 or AVX2), and one at a time with the channels packed
+// side by side in 32 bit words everywhere else, and for whatever is left over at the end of a run.  Either way the
+// results are exactly the same as the single pixel functions'.
+#if defined(__AVR__)
+
 void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
     for(int i = 0; i < numLeds; ++i) {
         hsv2rgb_raw(phsv[i], prgb[i]);
@@ -515,6 +532,301 @@ void hsv2rgb_spectrum( const struct CHSV* phsv, struct CRGB * prgb, int numLeds)
     }
 }
 
+#else
+
+// scale8( x, 85) and scale8( x, 170), as hsv2rgb_rainbow computes third and twothirds
+#define K_THIRD     (85 + (FASTLED_SCALE8_FIXED == 1))
+#define K_TWOTHIRDS (170 + (FASTLED_SCALE8_FIXED == 1))
+
+// Each of hsv2rgb_rainbow's eight hue sections, as base + third * KT + twothirds * KTT, with r and b in the low and
+// high halves of one word and g in another.  Some coefficients are negative, which works out (mod 2^32) because
+// every channel ends up back in 0..255.
+#define RB(R, B) ((uint32_t)((int32_t)(R) + (int32_t)(B) * 65536))
+static const uint32_t kRainbowRB[8][3] = {
+    { RB(255, 0),  RB(-1, 0),  0 },          // R -> O: r = 255 - third
+    { RB(171, 0),  0,          0 },          // O -> Y: r = 171
+    { RB(171, 0),  0,          RB(-1, 0) },  // Y -> G: r = 171 - twothirds
+    { 0,           RB(0, 1),   0 },          // G -> A: b = third
+    { RB(0, 85),   0,          RB(0, 1) },   // A -> B: b = 85 + twothirds
+    { RB(0, 255),  RB(1, -1),  0 },          // B -> P: r = third, b = 255 - third
+    { RB(85, 171), RB(1, -1),  0 },          // P -> K: r = 85 + third, b = 171 - third
+    { RB(170, 85), RB(1, -1),  0 },          // K -> R: r = 170 + third, b = 85 - third
+};
+static const int16_t kRainbowG[8][3] = {
+    { 0, 1, 0 }, { 85, 1, 0 }, { 170, 1, 0 }, { 255, -1, 0 }, { 171, 0, -1 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }
+};
+#undef RB
+
+// 1 in each 16 bit lane of x that isn't 0, for lanes holding 0..255
+#define RB_NONZERO(X) ((((X) + 0x00FF00FFUL) >> 8) & 0x00010001UL)
+
+static void hsv2rgb_rainbow_swar( const CHSV& hsv, CRGB& rgb)
+{
+    uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+    uint8_t section = hue >> 5;
+    uint32_t offset8 = (hue & 0x1F) << 3;
+
+    // third and twothirds from one multiply
+    uint32_t thirds = offset8 * (K_THIRD | (K_TWOTHIRDS << 16));
+    uint32_t third = (thirds >> 8) & 0xFF;
+    uint32_t twothirds = thirds >> 24;
+
+    uint32_t rb = kRainbowRB[section][0] + third * kRainbowRB[section][1] + twothirds * kRainbowRB[section][2];
+    uint32_t g = kRainbowG[section][0] + third * kRainbowG[section][1] + twothirds * kRainbowG[section][2];
+
+    // desaturate, then dim, as hsv2rgb_rainbow does
+    uint32_t desat = 255 - sat;
+    desat = ((desat * desat) >> 8) + (desat != 0);
+#if (FASTLED_SCALE8_FIXED == 1)
+    // with fixed scale8, sat == 255 and val == 255 scale by 256 (no change), and sat == 0 and val == 0 land on
+    // exactly the values they're special cased to
+    uint32_t satscale = 256 - desat;
+    rb = (((rb * satscale) >> 8) & 0x00FF00FF) + desat * 0x00010001;
+    g = ((g * satscale) >> 8) + desat;
+
+    uint32_t valscale = ((uint32_t)val * val >> 8) + (val != 0) + 1;
+    rb = ((rb * valscale) >> 8) & 0x00FF00FF;
+    g = (g * valscale) >> 8;
+#else
+    if( sat == 0) {
+        rb = 0x00FF00FF; g = 255;
+    } else {
+        uint32_t satscale = 255 - desat;
+        rb = (((rb * satscale) >> 8) & 0x00FF00FF) + RB_NONZERO(rb) + desat * 0x00010001;
+        g = ((g * satscale) >> 8) + (g != 0) + desat;
+    }
+
+    uint32_t valscale = ((uint32_t)val * val >> 8) + (val != 0);
+    if( valscale == 0) {
+        rb = 0; g = 0;
+    } else {
+        rb = (((rb * valscale) >> 8) & 0x00FF00FF) + RB_NONZERO(rb);
+        g = ((g * valscale) >> 8) + (g != 0);
+    }
+#endif
+
+    rgb.r = rb;
+    rgb.g = g;
+    rgb.b = rb >> 16;
+}
+
+static void hsv2rgb_raw_swar( const CHSV& hsv, CRGB& rgb)
+{
+    uint8_t hue = hsv.hue;
+    uint32_t val = hsv.val;
+    uint32_t brightness_floor = (val * (255 - hsv.sat)) >> 8;
+    uint32_t color_amplitude = val - brightness_floor;
+
+    // hues past HUE_MAX carry on with section 2, as in hsv2rgb_raw_C
+    uint32_t section = hue >> 6;
+    section -= section >> 1 & section;
+    uint32_t offset = hue & 0x3F;
+
+    // rampup and rampdown from one multiply, then rotated into place: section 0 is (rampdown, rampup, 0), section 1
+    // (0, rampdown, rampup) and section 2 (rampup, 0, rampdown), as r, g and b bytes
+    uint32_t ramps = color_amplitude * (offset | ((0x3F - offset) << 16));
+    uint32_t rgb24 = (ramps >> 22) | (((ramps & 0xFFFF) >> 6) << 8);
+    rgb24 = ((rgb24 << (section * 8)) | (rgb24 >> (24 - section * 8))) & 0xFFFFFF;
+    rgb24 += brightness_floor * 0x010101;
+
+    rgb.r = rgb24;
+    rgb.g = rgb24 >> 8;
+    rgb.b = rgb24 >> 16;
+}
+
+#if defined(HSV2RGB_LANES)
+
+// HSV2RGB_LANES pixels' worth of one channel, one 16 bit lane per pixel
+typedef uint16_t hsv2rgb_lanes_t __attribute__((vector_size(HSV2RGB_LANES * 2)));
+
+#define LANE_MASK(X) ((hsv2rgb_lanes_t)(X))
+// 1 in each lane of x that isn't 0, for lanes holding 0..255
+#define LANE_NONZERO(X) (((X) + 255) >> 8)
+
+#if defined(__AVX2__)
+// byte j of the hue (C = 0), saturation (1) or value (2) of 16 pixels, from the 16 byte block K of their 48 bytes
+#define HSV2RGB_GATHER(C, K, J) ((3 * (J) + (C) - 16 * (K)) >= 0 && (3 * (J) + (C) - 16 * (K)) < 16 ? (3 * (J) + (C) - 16 * (K)) : -128)
+// byte J of the 16 byte block K of 16 pixels' 48 bytes, if it is channel C
+#define HSV2RGB_SCATTER(C, K, J) ((16 * (K) + (J)) % 3 == (C) ? (16 * (K) + (J)) / 3 : -128)
+#define HSV2RGB_SHUFFLE(F, C, K) _mm_setr_epi8(F(C, K, 0), F(C, K, 1), F(C, K, 2), F(C, K, 3), F(C, K, 4), F(C, K, 5), \
+    F(C, K, 6), F(C, K, 7), F(C, K, 8), F(C, K, 9), F(C, K, 10), F(C, K, 11), F(C, K, 12), F(C, K, 13), F(C, K, 14), F(C, K, 15))
+
+#define HSV2RGB_LOAD(C) ((hsv2rgb_lanes_t)_mm256_cvtepu8_epi16(_mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, \
+    HSV2RGB_SHUFFLE(HSV2RGB_GATHER, C, 0)), _mm_shuffle_epi8(x1, HSV2RGB_SHUFFLE(HSV2RGB_GATHER, C, 1))), \
+    _mm_shuffle_epi8(x2, HSV2RGB_SHUFFLE(HSV2RGB_GATHER, C, 2)))))
+
+static inline void loadLanes( const CHSV* phsv, hsv2rgb_lanes_t& h, hsv2rgb_lanes_t& s, hsv2rgb_lanes_t& v)
+{
+    __m128i x0 = _mm_loadu_si128((const __m128i*)phsv);
+    __m128i x1 = _mm_loadu_si128((const __m128i*)((const uint8_t*)phsv + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)((const uint8_t*)phsv + 32));
+    h = HSV2RGB_LOAD(0);
+    s = HSV2RGB_LOAD(1);
+    v = HSV2RGB_LOAD(2);
+}
+
+#define HSV2RGB_STORE(K) _mm_storeu_si128((__m128i*)((uint8_t*)prgb + 16 * (K)), _mm_or_si128(_mm_or_si128( \
+    _mm_shuffle_epi8(r8, HSV2RGB_SHUFFLE(HSV2RGB_SCATTER, 0, K)), _mm_shuffle_epi8(g8, HSV2RGB_SHUFFLE(HSV2RGB_SCATTER, 1, K))), \
+    _mm_shuffle_epi8(b8, HSV2RGB_SHUFFLE(HSV2RGB_SCATTER, 2, K))))
+
+static inline __m128i packLanes( hsv2rgb_lanes_t x)
+{
+    return _mm_packus_epi16(_mm256_castsi256_si128((__m256i)x), _mm256_extracti128_si256((__m256i)x, 1));
+}
+
+static inline void storeLanes( CRGB* prgb, hsv2rgb_lanes_t r, hsv2rgb_lanes_t g, hsv2rgb_lanes_t b)
+{
+    __m128i r8 = packLanes(r), g8 = packLanes(g), b8 = packLanes(b);
+    HSV2RGB_STORE(0);
+    HSV2RGB_STORE(1);
+    HSV2RGB_STORE(2);
+}
+
+#elif defined(__SSE2__)
+
+#define HSV2RGB_LOAD(F) ((hsv2rgb_lanes_t)_mm_setr_epi16(phsv[0].F, phsv[1].F, phsv[2].F, phsv[3].F, \
+    phsv[4].F, phsv[5].F, phsv[6].F, phsv[7].F))
+
+static inline void loadLanes( const CHSV* phsv, hsv2rgb_lanes_t& h, hsv2rgb_lanes_t& s, hsv2rgb_lanes_t& v)
+{
+    h = HSV2RGB_LOAD(hue);
+    s = HSV2RGB_LOAD(sat);
+    v = HSV2RGB_LOAD(val);
+}
+
+static inline void storeLanes( CRGB* prgb, hsv2rgb_lanes_t r, hsv2rgb_lanes_t g, hsv2rgb_lanes_t b)
+{
+    // r | g << 8 | b << 16 for each pixel, written out 4 bytes at a time, each pixel's spare byte overwritten by
+    // the next pixel
+    __m128i rg = (__m128i)(r | (g << 8));
+    uint32_t words[8];
+    _mm_storeu_si128((__m128i*)words, _mm_unpacklo_epi16(rg, (__m128i)b));
+    _mm_storeu_si128((__m128i*)(words + 4), _mm_unpackhi_epi16(rg, (__m128i)b));
+    uint8_t *out = (uint8_t*)prgb;
+    for(int i = 0; i < 7; ++i) {
+        memcpy(out + (3 * i), words + i, 4);
+    }
+    memcpy(out + 21, words + 7, 3);
+}
+
+#endif
+
+// hsv2rgb_rainbow for HSV2RGB_LANES pixels: every section's values are worked out, and each lane keeps its own
+static inline void hsv2rgb_rainbow_lanes( const CHSV* phsv, CRGB* prgb)
+{
+    hsv2rgb_lanes_t hue, sat, val;
+    loadLanes(phsv, hue, sat, val);
+
+    hsv2rgb_lanes_t offset8 = (hue & 0x1F) << 3;
+    hsv2rgb_lanes_t third = (offset8 * K_THIRD) >> 8;
+    hsv2rgb_lanes_t twothirds = (offset8 * K_TWOTHIRDS) >> 8;
+
+    hsv2rgb_lanes_t section = hue >> 5;
+    hsv2rgb_lanes_t s0 = LANE_MASK(section == 0), s1 = LANE_MASK(section == 1), s2 = LANE_MASK(section == 2);
+    hsv2rgb_lanes_t s3 = LANE_MASK(section == 3), s4 = LANE_MASK(section == 4), s5 = LANE_MASK(section == 5);
+    hsv2rgb_lanes_t s6 = LANE_MASK(section == 6), s7 = LANE_MASK(section == 7);
+
+    hsv2rgb_lanes_t r = (s0 & (255 - third)) | (s1 & 171) | (s2 & (171 - twothirds)) |
+                        (s5 & third) | (s6 & (85 + third)) | (s7 & (170 + third));
+    hsv2rgb_lanes_t g = (s0 & third) | (s1 & (85 + third)) | (s2 & (170 + third)) | (s3 & (255 - third)) |
+                        (s4 & (171 - twothirds));
+    hsv2rgb_lanes_t b = (s3 & third) | (s4 & (85 + twothirds)) | (s5 & (255 - third)) | (s6 & (171 - third)) |
+                        (s7 & (85 - third));
+
+    hsv2rgb_lanes_t desat = 255 - sat;
+    desat = ((desat * desat) >> 8) + LANE_NONZERO(desat);
+#if (FASTLED_SCALE8_FIXED == 1)
+    // as in hsv2rgb_rainbow_swar, the special cases need no special handling with fixed scale8
+    hsv2rgb_lanes_t satscale = 256 - desat;
+    r = ((r * satscale) >> 8) + desat;
+    g = ((g * satscale) >> 8) + desat;
+    b = ((b * satscale) >> 8) + desat;
+
+    hsv2rgb_lanes_t valscale = ((val * val) >> 8) + LANE_NONZERO(val) + 1;
+    r = (r * valscale) >> 8;
+    g = (g * valscale) >> 8;
+    b = (b * valscale) >> 8;
+#else
+    hsv2rgb_lanes_t satscale = 255 - desat;
+    hsv2rgb_lanes_t nosat = LANE_MASK(sat == 0);
+    r = ((((r * satscale) >> 8) + LANE_NONZERO(r) + desat) & ~nosat) | (nosat & 255);
+    g = ((((g * satscale) >> 8) + LANE_NONZERO(g) + desat) & ~nosat) | (nosat & 255);
+    b = ((((b * satscale) >> 8) + LANE_NONZERO(b) + desat) & ~nosat) | (nosat & 255);
+
+    hsv2rgb_lanes_t valscale = ((val * val) >> 8) + LANE_NONZERO(val);
+    hsv2rgb_lanes_t lit = ~LANE_MASK(valscale == 0);
+    r = (((r * valscale) >> 8) + LANE_NONZERO(r)) & lit & 0xFF;
+    g = (((g * valscale) >> 8) + LANE_NONZERO(g)) & lit & 0xFF;
+    b = (((b * valscale) >> 8) + LANE_NONZERO(b)) & lit & 0xFF;
+#endif
+
+    storeLanes(prgb, r, g, b);
+}
+
+// hsv2rgb_raw_C for HSV2RGB_LANES pixels, with the hue scaled down to 0..191 first for hsv2rgb_spectrum
+template<bool SPECTRUM> static inline void hsv2rgb_raw_lanes( const CHSV* phsv, CRGB* prgb)
+{
+    hsv2rgb_lanes_t hue, sat, val;
+    loadLanes(phsv, hue, sat, val);
+    if(SPECTRUM) {
+        hue = (hue * (uint16_t)(191 + (FASTLED_SCALE8_FIXED == 1))) >> 8;
+    }
+
+    hsv2rgb_lanes_t brightness_floor = (val * (255 - sat)) >> 8;
+    hsv2rgb_lanes_t color_amplitude = val - brightness_floor;
+    hsv2rgb_lanes_t offset = hue & 0x3F;
+    hsv2rgb_lanes_t rampup = ((offset * color_amplitude) >> 6) + brightness_floor;
+    hsv2rgb_lanes_t rampdown = (((0x3F - offset) * color_amplitude) >> 6) + brightness_floor;
+
+    hsv2rgb_lanes_t section = hue >> 6;
+    hsv2rgb_lanes_t s0 = LANE_MASK(section == 0), s1 = LANE_MASK(section == 1), s2 = ~(s0 | s1);
+    storeLanes(prgb, (s0 & rampdown) | (s1 & brightness_floor) | (s2 & rampup),
+                     (s0 & rampup) | (s1 & rampdown) | (s2 & brightness_floor),
+                     (s0 & brightness_floor) | (s1 & rampup) | (s2 & rampdown));
+}
+
+#endif
+
+void hsv2rgb_raw(const struct CHSV * phsv, struct CRGB * prgb, int numLeds) {
+    int i = 0;
+#if defined(HSV2RGB_LANES)
+    for(; i + HSV2RGB_LANES <= numLeds; i += HSV2RGB_LANES) {
+        hsv2rgb_raw_lanes<false>(phsv + i, prgb + i);
+    }
+#endif
+    for(; i < numLeds; ++i) {
+        hsv2rgb_raw_swar(phsv[i], prgb[i]);
+    }
+}
+
+void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
+    int i = 0;
+#if defined(HSV2RGB_LANES)
+    for(; i + HSV2RGB_LANES <= numLeds; i += HSV2RGB_LANES) {
+        hsv2rgb_rainbow_lanes(phsv + i, prgb + i);
+    }
+#endif
+    for(; i < numLeds; ++i) {
+        hsv2rgb_rainbow_swar(phsv[i], prgb[i]);
+    }
+}
+
+void hsv2rgb_spectrum( const struct CHSV* phsv, struct CRGB * prgb, int numLeds) {
+    int i = 0;
+#if defined(HSV2RGB_LANES)
+    for(; i + HSV2RGB_LANES <= numLeds; i += HSV2RGB_LANES) {
+        hsv2rgb_raw_lanes<true>(phsv + i, prgb + i);
+    }
+#endif
+    for(; i < numLeds; ++i) {
+        CHSV hsv(phsv[i]);
+        hsv.hue = scale8( hsv.hue, 191);
+        hsv2rgb_raw_swar(hsv, prgb[i]);
+    }
+}
+
+#endif
+
 
 
 #define FIXFRAC8(N,D) (((N)*256)/(D))
@@ -14,6 +14,12 @@ FASTLED_NAMESPACE_BEGIN
 //                   than a straight 'spectrum'.
 //
 //                   NOTE: here hue is 0-255, not just 0-191
+//
+//                   The array versions of this and the functions below
+//                   convert runs of pixels several at a time, side by side
+//                   in vector registers where there are any, and give
+//                   exactly the same results as converting each pixel on
+//                   its own.  phsv and prgb may be the same memory.
 
 void hsv2rgb_rainbow( const struct CHSV& hsv, struct CRGB& rgb);
 void hsv2rgb_rainbow( const struct CHSV* phsv, struct CRGB * prgb, int numLeds);
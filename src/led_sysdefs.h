@@ -40,6 +40,9 @@
 #elif defined(ARDUINO_ARCH_APOLLO3)
 // Apollo3 platforms (e.g. the Ambiq Micro Apollo3 Blue as used by the SparkFun Artemis platforms)
 #include "platforms/apollo3/led_sysdefs_apollo3.h"
+#elif defined(FASTLED_HOST) || (defined(__linux__) && !defined(ARDUINO))
+// Desktop/CI build, output is captured rather than sent anywhere
+#include "platforms/host/led_sysdefs_host.h"
 #else
 //
 // We got here because we don't recognize the platform that you're
@@ -68,4 +71,17 @@
 
 #define CLKS_PER_US (F_CPU/1000000)
 
+// Allow clock that clockless controller is based on to have different
+// frequency than the CPU.
+#if !defined(CLOCKLESS_FREQUENCY)
+    #define CLOCKLESS_FREQUENCY F_CPU
+#endif
+
+// Clocks per microsecond of the T1/T2/T3 timings clockless controllers are given (see C_NS in chipsets.h)
+#ifdef FASTLED_TEENSY4
+#define CLOCKLESS_CLKS_PER_US 1000
+#else
+#define CLOCKLESS_CLKS_PER_US (CLOCKLESS_FREQUENCY/1000000)
+#endif
+
 #endif
@@ -736,7 +736,30 @@ void fill_noise16(CRGB *leds, int num_leds,
   }
 }
 
-void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
+// where fill_2dnoise8 and fill_2dnoise16 put the color for row i, column j: in rows, serpentine or not, or
+// through an XYMap's table
+struct NoiseRows {
+  int width;
+  bool serpentine;
+  NoiseRows(int w, bool s) : width(w), serpentine(s) {}
+  int operator()(int i, int j) const {
+    int pos = j;
+    if(serpentine && (i & 0x1)) {
+      pos = width-1-j;
+    }
+    return i*width + pos;
+  }
+};
+
+struct NoiseMapped {
+  const uint16_t *table;
+  int width;
+  NoiseMapped(const uint16_t *t, int w) : table(t), width(w) {}
+  int operator()(int i, int j) const { return table[i*width + j]; }
+};
+
+template<class POS>
+static void fill_2dnoise8_at(CRGB *leds, int width, int height, POS at,
             uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
             uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
   uint8_t V[height][width];
@@ -751,25 +774,22 @@ void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
   int w1 = width-1;
   int h1 = height-1;
   for(int i = 0; i < height; ++i) {
-    int wb = i*width;
     for(int j = 0; j < width; ++j) {
       CRGB led(CHSV(H[h1-i][w1-j],255,V[i][j]));
 
-      int pos = j;
-      if(serpentine && (i & 0x1)) {
-        pos = w1-j;
-      }
+      int pos = at(i, j);
 
       if(blend) {
-        leds[wb+pos] >>= 1; leds[wb+pos] += (led>>=1);
+        leds[pos] >>= 1; leds[pos] += (led>>=1);
       } else {
-        leds[wb+pos] = led;
+        leds[pos] = led;
       }
     }
   }
 }
 
-void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
+template<class POS>
+static void fill_2dnoise16_at(CRGB *leds, int width, int height, POS at,
             uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
             uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
   uint8_t V[height][width];
@@ -789,22 +809,60 @@ void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
   hue_shift >>= 8;
 
   for(int i = 0; i < height; ++i) {
-    int wb = i*width;
     for(int j = 0; j < width; ++j) {
       CRGB led(CHSV(hue_shift + (H[h1-i][w1-j]),196,V[i][j]));
 
-      int pos = j;
-      if(serpentine && (i & 0x1)) {
-        pos = w1-j;
-      }
+      int pos = at(i, j);
 
       if(blend) {
-        leds[wb+pos] >>= 1; leds[wb+pos] += (led>>=1);
+        leds[pos] >>= 1; leds[pos] += (led>>=1);
       } else {
-        leds[wb+pos] = led;
+        leds[pos] = led;
       }
     }
   }
 }
 
+void fill_2dnoise8(CRGB *leds, int width, int height, bool serpentine,
+            uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
+  fill_2dnoise8_at(leds, width, height, NoiseRows(width, serpentine), octaves, x, xscale, y, yscale, time,
+                   hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend);
+}
+
+void fill_2dnoise8(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint16_t x, int xscale, uint16_t y, int yscale, uint16_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time,bool blend) {
+  int width = xymap.width();
+  int height = xymap.height();
+  if(xymap.table()) {
+    fill_2dnoise8_at(leds, width, height, NoiseMapped(xymap.table(), width), octaves, x, xscale, y, yscale, time,
+                     hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend);
+  } else {
+    fill_2dnoise8_at(leds, width, height, NoiseRows(width, false), octaves, x, xscale, y, yscale, time,
+                     hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend);
+  }
+}
+
+void fill_2dnoise16(CRGB *leds, int width, int height, bool serpentine,
+            uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
+  fill_2dnoise16_at(leds, width, height, NoiseRows(width, serpentine), octaves, x, xscale, y, yscale, time,
+                    hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend, hue_shift);
+}
+
+void fill_2dnoise16(CRGB *leds, const XYMap &xymap,
+            uint8_t octaves, uint32_t x, int xscale, uint32_t y, int yscale, uint32_t time,
+            uint8_t hue_octaves, uint16_t hue_x, int hue_xscale, uint16_t hue_y, uint16_t hue_yscale,uint16_t hue_time, bool blend, uint16_t hue_shift) {
+  int width = xymap.width();
+  int height = xymap.height();
+  if(xymap.table()) {
+    fill_2dnoise16_at(leds, width, height, NoiseMapped(xymap.table(), width), octaves, x, xscale, y, yscale, time,
+                      hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend, hue_shift);
+  } else {
+    fill_2dnoise16_at(leds, width, height, NoiseRows(width, false), octaves, x, xscale, y, yscale, time,
+                      hue_octaves, hue_x, hue_xscale, hue_y, hue_yscale, hue_time, blend, hue_shift);
+  }
+}
+
 FASTLED_NAMESPACE_END
@@ -90,6 +90,7 @@ public:
 	}
 
 	virtual uint16_t getMaxRefreshRate() const { return 400; }
+	virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME, LANES>(nLeds); }
 
 	typedef union {
 		uint8_t bytes[12];
@@ -214,6 +215,9 @@ class SixteenWayInlineBlockClocklessController : public CPixelLEDController<RGB_
 	CMinWait<WAIT_TIME> mWait;
 
 public:
+	// size() is the number of leds per lane here, rather than of all of them
+	virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME>(nLeds); }
+
 	virtual void init() {
 		static_assert(LANES <= 16, "Maximum of 16 lanes for Teensy parallel controllers!");
 		// FastPin<30>::setOutput();
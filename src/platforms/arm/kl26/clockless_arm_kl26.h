@@ -21,6 +21,7 @@ public:
   }
 
   virtual uint16_t getMaxRefreshRate() const { return 400; }
+  virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME>(nLeds); }
 
   virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
     mWait.wait();
@@ -94,6 +94,9 @@ public:
     }
 
     virtual uint16_t getMaxRefreshRate() const { return 400; }
+    virtual uint32_t getWireMicros(int nLeds) const {
+        return m_nActualLanes ? clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME>((nLeds + m_nActualLanes - 1) / m_nActualLanes) : 0;
+    }
 
     virtual void showPixels(PixelController<RGB_ORDER, LANES, __FL_T4_MASK> & pixels) {
         mWait.wait();
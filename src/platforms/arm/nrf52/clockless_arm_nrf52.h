@@ -176,6 +176,7 @@ public:
 
     }
     virtual uint16_t getMaxRefreshRate() const { return 800; }
+    virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<_T1 + _T2 + _T3, _XTRA0, _WAIT_TIME_MICROSECONDS>(nLeds); }
 
     virtual void showPixels(PixelController<_RGB_ORDER> & pixels) {
         // wait for the only sequence buffer to become available
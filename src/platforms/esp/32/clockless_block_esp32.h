@@ -40,6 +40,7 @@ public:
 #ifdef FASTLED_DEBUG_COUNT_FRAME_RETRIES
 	    ++_retry_cnt;
 #endif
+	    FASTLED_STAT_ADD(retries, 1);
 	    delayMicroseconds(WAIT_TIME * 10);
 	    ets_intr_lock();
 	}
@@ -73,6 +74,7 @@ public:
     }
 
     virtual uint16_t getMaxRefreshRate() const { return 400; }
+    virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME, LANES>(nLeds); }
     
     typedef union {
 	uint8_t bytes[8];
@@ -238,6 +238,8 @@ public:
     }
     
     virtual uint16_t getMaxRefreshRate() const { return 400; }
+    virtual bool showsInBatch() const { return true; }
+    virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME>(nLeds); }
     
 protected:
    static int pgcd(int smallest,int precision,int a,int b,int c)
@@ -0,0 +1,59 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+#if defined(FASTLED_HOST)
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+FASTLED_NAMESPACE_BEGIN
+
+static std::atomic<bool> gUseVirtualClock(false);
+static std::atomic<uint64_t> gVirtualNanos(0);
+static std::atomic<uint32_t> gSpinStepNanos(100);
+
+static uint64_t steadyNanos() {
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CHostClock::useVirtualClock(bool bVirtual) {
+	gVirtualNanos = 0;
+	gUseVirtualClock = bVirtual;
+}
+
+bool CHostClock::isVirtual() { return gUseVirtualClock; }
+
+uint64_t CHostClock::nanos() {
+	if(gUseVirtualClock) {
+		// every read nudges virtual time forward so that busy-wait loops make progress
+		return gVirtualNanos.fetch_add(gSpinStepNanos) + gSpinStepNanos;
+	}
+	return steadyNanos();
+}
+
+void CHostClock::advance(uint64_t ns) {
+	if(gUseVirtualClock) { gVirtualNanos += ns; }
+}
+
+void CHostClock::setSpinStep(uint32_t ns) { gSpinStepNanos = ns; }
+
+void CHostClock::sleep(uint64_t ns) {
+	if(gUseVirtualClock) {
+		gVirtualNanos += ns;
+	} else {
+		std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+	}
+}
+
+FASTLED_NAMESPACE_END
+
+FASTLED_USING_NAMESPACE
+
+unsigned long millis() { return (unsigned long)(CHostClock::nanos() / 1000000); }
+unsigned long micros() { return (unsigned long)(CHostClock::nanos() / 1000); }
+void delay(unsigned long ms) { CHostClock::sleep((uint64_t)ms * 1000000); }
+void delayMicroseconds(unsigned int us) { CHostClock::sleep((uint64_t)us * 1000); }
+
+#endif
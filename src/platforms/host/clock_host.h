@@ -0,0 +1,32 @@
+#ifndef __INC_CLOCK_HOST_H
+#define __INC_CLOCK_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Time source behind millis()/micros()/delay() on the host.  By default this follows the host's steady clock.  In
+/// virtual mode time only moves when something moves it: delay()/delayMicroseconds() advance it by the requested amount,
+/// captured spi/clockless transfers advance it by their wire time, and every read advances it by a small spin step so
+/// that the library's busy-wait loops (CMinWait, the refresh rate cap in show()) still terminate.  This makes timing
+/// measurements on the host exactly repeatable.
+class CHostClock {
+public:
+	/// switch between the steady clock (false) and the virtual clock (true).  Switching resets the virtual clock to 0.
+	static void useVirtualClock(bool bVirtual);
+	static bool isVirtual();
+
+	/// current time in nanoseconds
+	static uint64_t nanos();
+
+	/// advance the virtual clock by ns nanoseconds (ignored when using the steady clock)
+	static void advance(uint64_t ns);
+
+	/// nanoseconds the virtual clock moves forward on every read, defaults to 100ns
+	static void setSpinStep(uint32_t ns);
+
+	/// block (steady clock) or advance (virtual clock) for the given number of nanoseconds
+	static void sleep(uint64_t ns);
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
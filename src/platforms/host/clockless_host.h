@@ -0,0 +1,65 @@
+#ifndef __INC_CLOCKLESS_HOST_H
+#define __INC_CLOCKLESS_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#if defined(FASTLED_HOST)
+
+// Clockless "output" for the host.  Instead of bit-banging, each frame is captured as a CHostTrace transfer holding the
+// encoded bytes (after scaling, dithering and reordering) along with the high/low timing the chipset would put on the
+// wire.  T1, T2 and T3 are in clocks, which are nanoseconds on the host (see F_CPU in led_sysdefs_host.h).
+
+#define FASTLED_HAS_CLOCKLESS 1
+
+template <uint8_t DATA_PIN, int T1, int T2, int T3, EOrder RGB_ORDER = RGB, int XTRA0 = 0, bool FLIP = false, int WAIT_TIME = 50>
+class ClocklessController : public CPixelLEDController<RGB_ORDER> {
+	CMinWait<WAIT_TIME> mWait;
+
+public:
+	virtual void init() {
+		FastPin<DATA_PIN>::setOutput();
+		FastPin<DATA_PIN>::lo();
+	}
+
+	virtual uint16_t getMaxRefreshRate() const { return 400; }
+	virtual uint32_t getWireMicros(int nLeds) const { return clocklessWireMicros<T1 + T2 + T3, XTRA0, WAIT_TIME>(nLeds); }
+
+protected:
+	virtual void showPixels(PixelController<RGB_ORDER> & pixels) {
+		mWait.wait();
+		showRGBInternal(pixels);
+		mWait.mark();
+	}
+
+	static void showRGBInternal(PixelController<RGB_ORDER> pixels) {
+		CHostTrace::beginClockless(DATA_PIN, T1 * 1000 / F_CPU_MHZ, (T1 + T2) * 1000 / F_CPU_MHZ, (T1 + T2 + T3) * 1000 / F_CPU_MHZ, 8 + XTRA0, FLIP);
+
+		// Setup the pixel controller and load/scale the first byte
+		pixels.preStepFirstByteDithering();
+		uint8_t b = pixels.loadAndScale0();
+
+		while(pixels.has(1)) {
+			pixels.stepDithering();
+
+			// Write first byte, read next byte
+			CHostTrace::writeByte(DATA_PIN, b);
+			b = pixels.loadAndScale1();
+
+			// Write second byte, read 3rd byte
+			CHostTrace::writeByte(DATA_PIN, b);
+			b = pixels.loadAndScale2();
+
+			// Write third byte, read 1st byte of next pixel
+			CHostTrace::writeByte(DATA_PIN, b);
+			b = pixels.advanceAndLoadAndScale0();
+		}
+
+		CHostTrace::end(DATA_PIN);
+	}
+};
+
+#endif
+
+FASTLED_NAMESPACE_END
+
+#endif
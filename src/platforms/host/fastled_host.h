@@ -0,0 +1,12 @@
+#ifndef __INC_FASTLED_HOST_H
+#define __INC_FASTLED_HOST_H
+
+#include "clock_host.h"
+#include "trace_host.h"
+#include "fastpin_host.h"
+#include "fastspi_host.h"
+#include "clockless_host.h"
+#include "show_worker_host.h"
+#include "show_pool_host.h"
+
+#endif
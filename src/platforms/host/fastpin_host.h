@@ -0,0 +1,61 @@
+#ifndef __INC_FASTPIN_HOST_H
+#define __INC_FASTPIN_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#if defined(FASTLED_FORCE_SOFTWARE_PINS)
+#warning "Software pin support forced, pin access will be slightly slower."
+#define NO_HARDWARE_PIN_SUPPORT
+#undef HAS_HARDWARE_PIN_SUPPORT
+
+#else
+
+/// Virtual pin - the level lives in CHostTrace, which also records the edge when edge capture is on
+template<uint8_t PIN> class _HOSTPIN {
+public:
+	typedef volatile uint32_t * port_ptr_t;
+	typedef uint32_t port_t;
+
+	inline static void setOutput() { }
+	inline static void setInput() { }
+
+	inline static void hi() __attribute__ ((always_inline)) { CHostTrace::setPin(PIN, 1); }
+	inline static void lo() __attribute__ ((always_inline)) { CHostTrace::setPin(PIN, 0); }
+	inline static void set(port_t val) __attribute__ ((always_inline)) { CHostTrace::setPin(PIN, val ? 1 : 0); }
+
+	inline static void strobe() __attribute__ ((always_inline)) { toggle(); toggle(); }
+
+	inline static void toggle() __attribute__ ((always_inline)) { CHostTrace::setPin(PIN, !CHostTrace::getPin(PIN)); }
+
+	inline static void hi(port_ptr_t) __attribute__ ((always_inline)) { hi(); }
+	inline static void lo(port_ptr_t) __attribute__ ((always_inline)) { lo(); }
+	inline static void fastset(port_ptr_t, port_t val) __attribute__ ((always_inline)) { set(val); }
+
+	inline static port_t hival() __attribute__ ((always_inline)) { return 1; }
+	inline static port_t loval() __attribute__ ((always_inline)) { return 0; }
+	inline static port_ptr_t port() __attribute__ ((always_inline)) { return CHostTrace::pinPort(PIN); }
+	inline static port_t mask() __attribute__ ((always_inline)) { return 1; }
+};
+
+#define _FL_DEFPIN(PIN) template<> class FastPin<PIN> : public _HOSTPIN<PIN> {};
+
+#define MAX_PIN 63
+_FL_DEFPIN(0); _FL_DEFPIN(1); _FL_DEFPIN(2); _FL_DEFPIN(3); _FL_DEFPIN(4); _FL_DEFPIN(5); _FL_DEFPIN(6); _FL_DEFPIN(7);
+_FL_DEFPIN(8); _FL_DEFPIN(9); _FL_DEFPIN(10); _FL_DEFPIN(11); _FL_DEFPIN(12); _FL_DEFPIN(13); _FL_DEFPIN(14); _FL_DEFPIN(15);
+_FL_DEFPIN(16); _FL_DEFPIN(17); _FL_DEFPIN(18); _FL_DEFPIN(19); _FL_DEFPIN(20); _FL_DEFPIN(21); _FL_DEFPIN(22); _FL_DEFPIN(23);
+_FL_DEFPIN(24); _FL_DEFPIN(25); _FL_DEFPIN(26); _FL_DEFPIN(27); _FL_DEFPIN(28); _FL_DEFPIN(29); _FL_DEFPIN(30); _FL_DEFPIN(31);
+_FL_DEFPIN(32); _FL_DEFPIN(33); _FL_DEFPIN(34); _FL_DEFPIN(35); _FL_DEFPIN(36); _FL_DEFPIN(37); _FL_DEFPIN(38); _FL_DEFPIN(39);
+_FL_DEFPIN(40); _FL_DEFPIN(41); _FL_DEFPIN(42); _FL_DEFPIN(43); _FL_DEFPIN(44); _FL_DEFPIN(45); _FL_DEFPIN(46); _FL_DEFPIN(47);
+_FL_DEFPIN(48); _FL_DEFPIN(49); _FL_DEFPIN(50); _FL_DEFPIN(51); _FL_DEFPIN(52); _FL_DEFPIN(53); _FL_DEFPIN(54); _FL_DEFPIN(55);
+_FL_DEFPIN(56); _FL_DEFPIN(57); _FL_DEFPIN(58); _FL_DEFPIN(59); _FL_DEFPIN(60); _FL_DEFPIN(61); _FL_DEFPIN(62); _FL_DEFPIN(63);
+
+#define SPI_DATA 11
+#define SPI_CLOCK 13
+
+#define HAS_HARDWARE_PIN_SUPPORT 1
+
+#endif
+
+FASTLED_NAMESPACE_END
+
+#endif
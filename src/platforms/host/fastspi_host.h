@@ -0,0 +1,117 @@
+#ifndef __INC_FASTSPI_HOST_H
+#define __INC_FASTSPI_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+#if defined(FASTLED_HOST)
+
+#define FASTLED_ALL_PINS_HARDWARE_SPI
+
+/// Spi output for the host.  Every byte written between select() and release() is captured as one CHostTrace transfer
+/// on _DATA_PIN, along with the bit time implied by _SPI_CLOCK_DIVIDER (one clock is one nanosecond on the host).
+template <uint8_t _DATA_PIN, uint8_t _CLOCK_PIN, uint32_t _SPI_CLOCK_DIVIDER>
+class HostSPIOutput {
+	Selectable *m_pSelect;
+
+public:
+	HostSPIOutput() { m_pSelect = NULL; }
+	HostSPIOutput(Selectable *pSelect) { m_pSelect = pSelect; }
+
+	// set the object representing the selectable
+	void setSelect(Selectable *pSelect) { m_pSelect = pSelect; }
+
+	// initialize the pins
+	void init() {
+		FastPin<_CLOCK_PIN>::setOutput();
+		FastPin<_CLOCK_PIN>::lo();
+		FastPin<_DATA_PIN>::setOutput();
+		FastPin<_DATA_PIN>::lo();
+	}
+
+	// latch the CS select
+	void inline select() __attribute__((always_inline)) {
+		if(m_pSelect != NULL) { m_pSelect->select(); }
+		CHostTrace::beginSPI(_DATA_PIN, _CLOCK_PIN, _SPI_CLOCK_DIVIDER * 1000 / F_CPU_MHZ);
+	}
+
+	// release the CS select
+	void inline release() __attribute__((always_inline)) {
+		CHostTrace::end(_DATA_PIN);
+		if(m_pSelect != NULL) { m_pSelect->release(); }
+	}
+
+	// wait until all queued up data has been written
+	static void waitFully() { }
+
+	// write a byte out via SPI
+	static void writeByte(uint8_t b) { CHostTrace::writeByte(_DATA_PIN, b); }
+
+	// write a word out via SPI
+	static void writeWord(uint16_t w) {
+		writeByte((uint8_t)(w >> 8));
+		writeByte((uint8_t)(w & 0xFF));
+	}
+
+	// A raw set of writing byte values, assumes setup/init/waiting done elsewhere
+	static void writeBytesValueRaw(uint8_t value, int len) {
+		while(len--) { writeByte(value); }
+	}
+
+	// A full cycle of writing a value for len bytes, including select, release, and waiting
+	void writeBytesValue(uint8_t value, int len) {
+		select(); writeBytesValueRaw(value, len); release();
+	}
+
+	// A full cycle of writing a value for len bytes, including select, release, and waiting
+	template <class D> void writeBytes(uint8_t *data, int len) {
+		uint8_t *end = data + len;
+		select();
+		while(data != end) {
+			writeByte(D::adjust(*data++));
+		}
+		D::postBlock(len);
+		waitFully();
+		release();
+	}
+
+	// A full cycle of writing a raw block of data out, including select, release, and waiting
+	void writeBytes(uint8_t *data, int len) {
+		select();
+		CHostTrace::writeBytes(_DATA_PIN, data, len);
+		release();
+	}
+
+	// write a single bit out, which bit from the passed in byte is determined by template parameter.  Single bits
+	// are captured as a whole byte holding just that bit (only SM16716 uses this).
+	template <uint8_t BIT> inline static void writeBit(uint8_t b) {
+		writeByte((b & (1 << BIT)) ? 0x01 : 0x00);
+	}
+
+	// write a block of uint8_ts out in groups of three.  len is the total number of uint8_ts to write out.  The template
+	// parameters indicate how many uint8_ts to skip at the beginning and/or end of each grouping
+	template <uint8_t FLAGS, class D, EOrder RGB_ORDER> void writePixels(PixelController<RGB_ORDER> pixels) {
+		select();
+
+		int len = pixels.mLen;
+
+		while(pixels.has(1)) {
+			if(FLAGS & FLAG_START_BIT) {
+				writeBit<0>(1);
+			}
+			writeByte(D::adjust(pixels.loadAndScale0()));
+			writeByte(D::adjust(pixels.loadAndScale1()));
+			writeByte(D::adjust(pixels.loadAndScale2()));
+
+			pixels.advanceData();
+			pixels.stepDithering();
+		}
+		D::postBlock(len);
+		release();
+	}
+};
+
+#endif
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __INC_LED_SYSDEFS_HOST_H
+#define __INC_LED_SYSDEFS_HOST_H
+
+// Host (Linux/macOS) build of FastLED.  There is no real hardware behind any of this - pins, spi and clockless
+// output are captured into an in-memory trace (see trace_host.h) so that the library can be compiled, tested
+// and benchmarked on a desktop machine or in CI.
+
+#ifndef FASTLED_HOST
+#define FASTLED_HOST
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef INTERRUPT_THRESHOLD
+#define INTERRUPT_THRESHOLD 1
+#endif
+
+// Default to allowing interrupts
+#ifndef FASTLED_ALLOW_INTERRUPTS
+#define FASTLED_ALLOW_INTERRUPTS 1
+#endif
+
+#if FASTLED_ALLOW_INTERRUPTS == 1
+#define FASTLED_ACCURATE_CLOCK
+#endif
+
+// Pretend to be a 1GHz part - one clock is one nanosecond, which keeps the clockless T1/T2/T3 values (see C_NS)
+// and the spi clock dividers in directly readable units in the captured trace.
+#ifndef F_CPU
+#define F_CPU 1000000000L
+#endif
+
+// Default to NOT using PROGMEM
+#ifndef FASTLED_USE_PROGMEM
+#define FASTLED_USE_PROGMEM 0
+#endif
+
+// data type defs
+typedef volatile uint32_t RoReg;
+typedef volatile uint32_t RwReg;
+
+#define FASTLED_NO_PINMAP
+
+// no interrupts to mask on the host
+#define cli()
+#define sei()
+
+// Arduino style timing functions, backed by either the host's steady clock or a virtual clock (see clock_host.h)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+#define FASTLED_HAS_MILLIS
+
+// FastLED.showAsync() writes frames out from a background thread (see show_worker_host.h)
+#define FASTLED_HAS_SHOW_WORKER
+
+// FastLED.show can write controllers out from several threads at once (see show_pool_host.h)
+#define FASTLED_HAS_SHOW_POOL
+
+#define FASTLED_NEEDS_YIELD
+extern "C" void yield();
+
+#endif
@@ -0,0 +1,86 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+#if defined(FASTLED_HOST)
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+FASTLED_NAMESPACE_BEGIN
+
+// Like the show worker, the pool threads are never joined, so these are never destroyed.
+static std::mutex & gPoolLock = *new std::mutex;
+static std::condition_variable & gPoolStart = *new std::condition_variable;
+static std::condition_variable & gPoolDone = *new std::condition_variable;
+static int gWorkers = 1;
+static int gThreads = 0;
+static uint32_t gRun = 0;		// counts runs, so that the threads can tell a new one has started
+static int gRunWorkers = 1;		// gWorkers when the current run started
+static int gBusy = 0;			// threads still working on the current run
+static void (*gFunc)(void *, int) = NULL;
+static void *gArg = NULL;
+static int gJobs = 0;
+static std::atomic<int> gNext(0);
+
+static void runJobs() {
+	int i;
+	while((i = gNext.fetch_add(1)) < gJobs) {
+		gFunc(gArg, i);
+	}
+}
+
+static void poolMain(int nThread, uint32_t nSeen) {
+	std::unique_lock<std::mutex> lock(gPoolLock);
+	for(;;) {
+		gPoolStart.wait(lock, [&] { return gRun != nSeen; });
+		nSeen = gRun;
+		// threads past the current number of workers sit this run out
+		if(nThread >= gRunWorkers - 1) { continue; }
+		lock.unlock();
+		runJobs();
+		lock.lock();
+		if(--gBusy == 0) { gPoolDone.notify_all(); }
+	}
+}
+
+void CShowPool::setWorkers(int nWorkers) {
+	std::lock_guard<std::mutex> lock(gPoolLock);
+	gWorkers = (nWorkers < 1) ? 1 : nWorkers;
+}
+
+int CShowPool::workers() {
+	std::lock_guard<std::mutex> lock(gPoolLock);
+	return gWorkers;
+}
+
+void CShowPool::run(void (*pFunc)(void *, int), void *pArg, int nJobs) {
+	std::unique_lock<std::mutex> lock(gPoolLock);
+	if(gWorkers < 2 || nJobs < 2) {
+		lock.unlock();
+		for(int i = 0; i < nJobs; ++i) { pFunc(pArg, i); }
+		return;
+	}
+	while(gThreads < gWorkers - 1) {
+		std::thread(poolMain, gThreads++, gRun).detach();
+	}
+	gFunc = pFunc;
+	gArg = pArg;
+	gJobs = nJobs;
+	gNext = 0;
+	gRunWorkers = gWorkers;
+	gBusy = gWorkers - 1;
+	++gRun;
+	gPoolStart.notify_all();
+	lock.unlock();
+
+	runJobs();
+
+	lock.lock();
+	gPoolDone.wait(lock, [] { return gBusy == 0; });
+}
+
+FASTLED_NAMESPACE_END
+
+#endif
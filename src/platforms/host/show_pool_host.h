@@ -0,0 +1,22 @@
+#ifndef __INC_SHOW_POOL_HOST_H
+#define __INC_SHOW_POOL_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// The worker threads behind FastLED.setShowWorkers on the host.  A run hands out its jobs from a shared counter, so
+/// whichever worker is free takes the next one and a slow job doesn't hold up the ones queued behind it.  The calling
+/// thread works on the jobs too, and the run returns once all of them are done.
+class CShowPool {
+public:
+	/// set the number of workers, counting the calling thread.  Threads are started as they are first needed, and
+	/// left idle (not stopped) when the number goes down.
+	static void setWorkers(int nWorkers);
+	static int workers();
+
+	/// run pFunc(pArg, i) for every i from 0 to nJobs - 1, spread over the workers, and wait for all of them
+	static void run(void (*pFunc)(void *, int), void *pArg, int nJobs);
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,58 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+#if defined(FASTLED_HOST)
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+FASTLED_NAMESPACE_BEGIN
+
+// The worker thread is never joined, so these are never destroyed - destroying a condition variable that the
+// worker is still waiting on would block the process from exiting.
+static std::mutex & gWorkerLock = *new std::mutex;
+static std::condition_variable & gWorkerSignal = *new std::condition_variable;
+static void (*gJobFunc)(void *) = NULL;
+static void *gJobArg = NULL;
+static bool gWorkerStarted = false;
+
+static void workerMain() {
+	std::unique_lock<std::mutex> lock(gWorkerLock);
+	for(;;) {
+		gWorkerSignal.wait(lock, [] { return gJobFunc != NULL; });
+		void (*pFunc)(void *) = gJobFunc;
+		lock.unlock();
+		pFunc(gJobArg);
+		lock.lock();
+		gJobFunc = NULL;
+		gWorkerSignal.notify_all();
+	}
+}
+
+void CShowWorker::start(void (*pFunc)(void *), void *pArg) {
+	std::unique_lock<std::mutex> lock(gWorkerLock);
+	if(!gWorkerStarted) {
+		// started on first use, and left running until the process exits
+		std::thread(workerMain).detach();
+		gWorkerStarted = true;
+	}
+	gWorkerSignal.wait(lock, [] { return gJobFunc == NULL; });
+	gJobFunc = pFunc;
+	gJobArg = pArg;
+	gWorkerSignal.notify_all();
+}
+
+void CShowWorker::wait() {
+	std::unique_lock<std::mutex> lock(gWorkerLock);
+	gWorkerSignal.wait(lock, [] { return gJobFunc == NULL; });
+}
+
+bool CShowWorker::busy() {
+	std::lock_guard<std::mutex> lock(gWorkerLock);
+	return gJobFunc != NULL;
+}
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef __INC_SHOW_WORKER_HOST_H
+#define __INC_SHOW_WORKER_HOST_H
+
+FASTLED_NAMESPACE_BEGIN
+
+/// The transmit context behind FastLED.showAsync() on the host: a single background thread that runs one job at a
+/// time, so that the time spent writing a frame out overlaps with rendering the next one and can be measured.
+class CShowWorker {
+public:
+	/// run pFunc(pArg) on the worker thread and return immediately.  Waits for the previous job first.
+	static void start(void (*pFunc)(void *), void *pArg);
+
+	/// block until the current job, if any, is done
+	static void wait();
+
+	/// true while a job is running
+	static bool busy();
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
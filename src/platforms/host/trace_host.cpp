@@ -0,0 +1,181 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+
+#if defined(FASTLED_HOST)
+
+#include <atomic>
+#include <mutex>
+
+FASTLED_NAMESPACE_BEGIN
+
+// Transfers are opened per data pin, so several controllers (or threads driving them) can be mid-transfer at once.  The
+// open transfer of a pin is only touched by whoever drives that pin, so only the shared lists need the lock.
+static std::mutex gTraceLock;
+static std::atomic<bool> gTraceEnabled(true);
+static std::atomic<bool> gCaptureEdges(false);
+static std::atomic<bool> gHoldForWireTime(false);
+static std::vector<CHostTrace::Transfer> gTransfers;
+static std::vector<CHostTrace::Edge> gEdges;
+static CHostTrace::Transfer gOpen[256];
+static bool gIsOpen[256];
+static uint64_t gOpenCount[256];
+static uint64_t gByteCount[256];
+static volatile uint32_t gPinLevels[256];
+
+bool CHostTrace::Transfer::levelAt(uint64_t nsOffset) const {
+	uint64_t bit = nsOffset / bitNs;
+	uint64_t inBit = nsOffset % bitNs;
+	uint64_t byte = bit / bitsPerByte;
+	uint8_t bitInByte = bit % bitsPerByte;
+	bool level = false;
+	if(byte < bytes.size()) {
+		// bits past the first 8 of a byte are the XTRA0 padding zeros
+		bool one = (bitInByte < 8) && (bytes[byte] & (0x80 >> bitInByte));
+		level = inBit < (one ? t1hNs : t0hNs);
+	}
+	return flip ? !level : level;
+}
+
+void CHostTrace::enable(bool bEnable) { gTraceEnabled = bEnable; }
+bool CHostTrace::enabled() { return gTraceEnabled; }
+void CHostTrace::captureEdges(bool bEnable) { gCaptureEdges = bEnable; }
+void CHostTrace::holdForWireTime(bool bEnable) { gHoldForWireTime = bEnable; }
+
+void CHostTrace::clear() {
+	std::lock_guard<std::mutex> lock(gTraceLock);
+	gTransfers.clear();
+	gEdges.clear();
+	for(int i = 0; i < 256; ++i) { gByteCount[i] = 0; }
+}
+
+std::vector<CHostTrace::Transfer> CHostTrace::transfers() {
+	std::lock_guard<std::mutex> lock(gTraceLock);
+	return gTransfers;
+}
+
+std::vector<CHostTrace::Edge> CHostTrace::edges() {
+	std::lock_guard<std::mutex> lock(gTraceLock);
+	return gEdges;
+}
+
+uint64_t CHostTrace::byteCount() {
+	uint64_t count = 0;
+	for(int i = 0; i < 256; ++i) { count += gByteCount[i]; }
+	return count;
+}
+
+std::vector<uint8_t> CHostTrace::bytes(uint8_t dataPin) {
+	std::lock_guard<std::mutex> lock(gTraceLock);
+	std::vector<uint8_t> out;
+	for(size_t i = 0; i < gTransfers.size(); ++i) {
+		if(gTransfers[i].dataPin == dataPin) {
+			out.insert(out.end(), gTransfers[i].bytes.begin(), gTransfers[i].bytes.end());
+		}
+	}
+	return out;
+}
+
+const CHostTrace::Transfer *CHostTrace::last(uint8_t dataPin) {
+	std::lock_guard<std::mutex> lock(gTraceLock);
+	for(size_t i = gTransfers.size(); i > 0; --i) {
+		if(gTransfers[i-1].dataPin == dataPin) { return &gTransfers[i-1]; }
+	}
+	return NULL;
+}
+
+static void beginTransfer(uint8_t dataPin, const CHostTrace::Transfer & proto) {
+	if(gIsOpen[dataPin]) { return; }
+	CHostTrace::Transfer & t = gOpen[dataPin];
+	t = proto;
+	t.dataPin = dataPin;
+	t.startNs = CHostClock::nanos();
+	t.bytes.clear();
+	gOpenCount[dataPin] = 0;
+	gIsOpen[dataPin] = true;
+}
+
+void CHostTrace::beginSPI(uint8_t dataPin, uint8_t clockPin, uint32_t bitNs) {
+	Transfer proto;
+	proto.type = SPI_TRANSFER;
+	proto.clockPin = clockPin;
+	proto.bitsPerByte = 8;
+	proto.flip = false;
+	proto.bitNs = bitNs ? bitNs : 1;
+	proto.t0hNs = proto.t1hNs = 0;
+	beginTransfer(dataPin, proto);
+}
+
+void CHostTrace::beginClockless(uint8_t dataPin, uint32_t t0hNs, uint32_t t1hNs, uint32_t bitNs, uint8_t bitsPerByte, bool flip) {
+	Transfer proto;
+	proto.type = CLOCKLESS_TRANSFER;
+	proto.clockPin = NO_PIN;
+	proto.bitsPerByte = bitsPerByte;
+	proto.flip = flip;
+	proto.bitNs = bitNs ? bitNs : 1;
+	proto.t0hNs = t0hNs;
+	proto.t1hNs = t1hNs;
+	beginTransfer(dataPin, proto);
+}
+
+void CHostTrace::writeByte(uint8_t dataPin, uint8_t b) {
+	writeBytes(dataPin, &b, 1);
+}
+
+void CHostTrace::writeBytes(uint8_t dataPin, const uint8_t *data, int len) {
+	gByteCount[dataPin] += len;
+	if(!gIsOpen[dataPin]) {
+		// a write without select() - spi code that drives the bus outside of a transaction, e.g. SM16716's header
+		Transfer & t = gOpen[dataPin];
+		t.type = SPI_TRANSFER;
+		t.dataPin = dataPin;
+		t.clockPin = NO_PIN;
+		t.bitsPerByte = 8;
+		t.flip = false;
+		t.bitNs = 1;
+		t.t0hNs = t.t1hNs = 0;
+		t.startNs = CHostClock::nanos();
+		t.bytes.clear();
+		gOpenCount[dataPin] = 0;
+		gIsOpen[dataPin] = true;
+	}
+	gOpenCount[dataPin] += len;
+	if(gTraceEnabled) {
+		gOpen[dataPin].bytes.insert(gOpen[dataPin].bytes.end(), data, data + len);
+	}
+}
+
+void CHostTrace::end(uint8_t dataPin) {
+	if(!gIsOpen[dataPin]) { return; }
+	gIsOpen[dataPin] = false;
+	uint64_t wireNs = gOpenCount[dataPin] * gOpen[dataPin].bitsPerByte * gOpen[dataPin].bitNs;
+	if(gTraceEnabled) {
+		std::lock_guard<std::mutex> lock(gTraceLock);
+		gTransfers.push_back(gOpen[dataPin]);
+	}
+	// the real hardware would be busy for the wire time of the transfer
+	if(gHoldForWireTime) {
+		CHostClock::sleep(wireNs);
+	} else {
+		CHostClock::advance(wireNs);
+	}
+}
+
+void CHostTrace::setPin(uint8_t pin, uint8_t level) {
+	if(gCaptureEdges && gPinLevels[pin] != level) {
+		std::lock_guard<std::mutex> lock(gTraceLock);
+		Edge e;
+		e.ns = CHostClock::nanos();
+		e.pin = pin;
+		e.level = level;
+		gEdges.push_back(e);
+	}
+	gPinLevels[pin] = level;
+}
+
+uint8_t CHostTrace::getPin(uint8_t pin) { return gPinLevels[pin]; }
+
+volatile uint32_t *CHostTrace::pinPort(uint8_t pin) { return &gPinLevels[pin]; }
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef __INC_TRACE_HOST_H
+#define __INC_TRACE_HOST_H
+
+#include <vector>
+
+FASTLED_NAMESPACE_BEGIN
+
+/// In-memory capture of everything the host platform "puts on the wire".  Spi and clockless controllers record one
+/// transfer per select()/release() (spi) or per frame (clockless); FastPin records individual edges when edge capture
+/// is turned on (off by default, it is expensive and only useful for pin level tests).
+class CHostTrace {
+public:
+	enum ETransferType { SPI_TRANSFER, CLOCKLESS_TRANSFER };
+
+	/// A single captured transfer on a data pin
+	struct Transfer {
+		ETransferType type;
+		uint8_t dataPin;
+		uint8_t clockPin;          ///< NO_PIN for clockless transfers
+		uint8_t bitsPerByte;       ///< 8, or 8 + the number of trailing zero bits for clockless chipsets with XTRA0
+		bool flip;                 ///< clockless output is inverted
+		uint32_t bitNs;            ///< length of one bit on the wire
+		uint32_t t0hNs;            ///< clockless: time the line is held high for a zero bit
+		uint32_t t1hNs;            ///< clockless: time the line is held high for a one bit
+		uint64_t startNs;          ///< clock time when the first byte was written
+		std::vector<uint8_t> bytes;
+
+		/// time this transfer occupies the wire
+		uint64_t wireNs() const { return (uint64_t)bytes.size() * bitsPerByte * bitNs; }
+		/// state of the data line nsOffset nanoseconds into the transfer (clockless only)
+		bool levelAt(uint64_t nsOffset) const;
+	};
+
+	/// A single captured pin level change
+	struct Edge {
+		uint64_t ns;
+		uint8_t pin;
+		uint8_t level;
+	};
+
+	/// turn capture on or off entirely (on by default).  When off, output costs nothing beyond the encode itself,
+	/// which is what benchmarks want.
+	static void enable(bool bEnable);
+	static bool enabled();
+
+	/// turn FastPin edge capture on or off (off by default)
+	static void captureEdges(bool bEnable);
+
+	/// when on, every transfer blocks for its wire time on the steady clock, the way real output would (off by default,
+	/// the virtual clock is always advanced by the wire time instead).  Lets FastLED.showAsync's overlap be timed.
+	static void holdForWireTime(bool bEnable);
+
+	/// drop everything captured so far
+	static void clear();
+
+	/// a copy of all completed transfers, oldest first.  Output running on other threads (show workers, showAsync)
+	/// can add to the capture at any time, so this is taken under the capture's lock.
+	static std::vector<Transfer> transfers();
+	/// a copy of all captured edges, oldest first
+	static std::vector<Edge> edges();
+	/// the concatenated bytes of every completed transfer on the given data pin
+	static std::vector<uint8_t> bytes(uint8_t dataPin);
+	/// the most recent completed transfer on the given data pin, NULL if there is none.  The transfer is only good
+	/// until the next one completes, so only look at it while no output is running.
+	static const Transfer *last(uint8_t dataPin);
+	/// total number of bytes written out since the last clear(), counted even when capture is disabled
+	static uint64_t byteCount();
+
+	// used by the host FastPin/SPI/clockless implementations
+	static void beginSPI(uint8_t dataPin, uint8_t clockPin, uint32_t bitNs);
+	static void beginClockless(uint8_t dataPin, uint32_t t0hNs, uint32_t t1hNs, uint32_t bitNs, uint8_t bitsPerByte, bool flip);
+	static void writeByte(uint8_t dataPin, uint8_t b);
+	static void writeBytes(uint8_t dataPin, const uint8_t *data, int len);
+	static void end(uint8_t dataPin);
+	static void setPin(uint8_t pin, uint8_t level);
+	static uint8_t getPin(uint8_t pin);
+	static volatile uint32_t *pinPort(uint8_t pin);
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -47,6 +47,22 @@ static const uint8_t gMCU_mW  =  25 * 5; // 25mA @ 5v = 125 mW
 static uint8_t  gMaxPowerIndicatorLEDPinNumber = 0; // default = Arduino onboard LED pin.  set to zero to skip this.
 
 
+// turn summed up red, green and blue values (0-255 per led) into mW
+static inline uint32_t unscaled_power_mW_for_totals( uint32_t red32, uint32_t green32, uint32_t blue32, uint32_t numLeds)
+{
+    red32   *= gRed_mW;
+    green32 *= gGreen_mW;
+    blue32  *= gBlue_mW;
+
+    red32   >>= 8;
+    green32 >>= 8;
+    blue32  >>= 8;
+
+    uint32_t total = red32 + green32 + blue32 + (gDark_mW * numLeds);
+
+    return total;
+}
+
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds ) //25354
 {
     uint32_t red32 = 0, green32 = 0, blue32 = 0;
@@ -63,27 +79,52 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds )
         --count;
     }
 
-    red32   *= gRed_mW;
-    green32 *= gGreen_mW;
-    blue32  *= gBlue_mW;
+    return unscaled_power_mW_for_totals( red32, green32, blue32, numLeds);
+}
 
-    red32   >>= 8;
-    green32 >>= 8;
-    blue32  >>= 8;
 
-    uint32_t total = red32 + green32 + blue32 + (gDark_mW * numLeds);
+// Per pixel brightness (APA102 style, 0-31) scales the current drawn by
+// each channel, so the color values are weighted by brt/31.  The brightness
+// comes from the pixels themselves (CRGB5b) or from a separate array.
+struct CPackedBrightness {
+    const CRGB5b* p;
+    inline uint8_t operator()( uint16_t i) const { return p[i].brt; }
+};
 
-    return total;
-}
+struct CSplitBrightness {
+    const uint8_t* p;
+    inline uint8_t operator()( uint16_t i) const { return p[i]; }
+};
 
+template<class PIXEL, class BRIGHTNESS>
+static uint32_t calculate_unscaled_5b_power_mW( const PIXEL* ledbuffer, BRIGHTNESS brt, uint16_t numLeds)
+{
+    uint32_t red32 = 0, green32 = 0, blue32 = 0;
 
-uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_V, uint32_t max_power_mA) {
-	return calculate_max_brightness_for_power_mW(ledbuffer, numLeds, target_brightness, max_power_V * max_power_mA);
+    for( uint16_t i = 0; i < numLeds; ++i) {
+        uint8_t b = brt(i) & 0x1F;
+        red32   += (uint32_t)ledbuffer[i].r * b;
+        green32 += (uint32_t)ledbuffer[i].g * b;
+        blue32  += (uint32_t)ledbuffer[i].b * b;
+    }
+
+    return unscaled_power_mW_for_totals( red32 / 31, green32 / 31, blue32 / 31, numLeds);
 }
 
-uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
- 	uint32_t total_mW = calculate_unscaled_power_mW( ledbuffer, numLeds);
+uint32_t calculate_unscaled_power_mW( const CRGB5b* ledbuffer, uint16_t numLeds )
+{
+    CPackedBrightness brt = { ledbuffer };
+    return calculate_unscaled_5b_power_mW( ledbuffer, brt, numLeds);
+}
 
+uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, const uint8_t* bdata, uint16_t numLeds )
+{
+    CSplitBrightness brt = { bdata };
+    return calculate_unscaled_5b_power_mW( ledbuffer, brt, numLeds);
+}
+
+static uint8_t max_brightness_for_unscaled_power_mW( uint32_t total_mW, uint8_t target_brightness, uint32_t max_power_mW)
+{
 	uint32_t requested_power_mW = ((uint32_t)total_mW * target_brightness) / 256;
 
 	uint8_t recommended_brightness = target_brightness;
@@ -94,6 +135,22 @@ uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t nu
 	return recommended_brightness;
 }
 
+uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_V, uint32_t max_power_mA) {
+	return calculate_max_brightness_for_power_mW(ledbuffer, numLeds, target_brightness, max_power_V * max_power_mA);
+}
+
+uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
+	return max_brightness_for_unscaled_power_mW( calculate_unscaled_power_mW( ledbuffer, numLeds), target_brightness, max_power_mW);
+}
+
+uint8_t calculate_max_brightness_for_power_mW(const CRGB5b* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
+	return max_brightness_for_unscaled_power_mW( calculate_unscaled_power_mW( ledbuffer, numLeds), target_brightness, max_power_mW);
+}
+
+uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, const uint8_t* bdata, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW) {
+	return max_brightness_for_unscaled_power_mW( calculate_unscaled_power_mW( ledbuffer, bdata, numLeds), target_brightness, max_power_mW);
+}
+
 // sets brightness to
 //  - no more than target_brightness
 //  - no more than max_mW milliwatts
@@ -103,7 +160,24 @@ uint8_t calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32
 
     CLEDController *pCur = CLEDController::head();
 	while(pCur) {
-        total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+#if FASTLED_POWER_FUSED == 1
+        // use the totals summed up while the last frame was written out when there are some, instead of walking
+        // the led data again.  This puts the power limiting one frame behind.
+        const uint32_t *pTotals = pCur->lastFramePower();
+        if( pTotals) {
+            total_mW += unscaled_power_mW_for_totals( pTotals[0], pTotals[1], pTotals[2], pTotals[3]);
+            pCur = pCur->next();
+            continue;
+        }
+#endif
+        // use the per pixel brightness when the controller has some
+        if( pCur->leds5b()) {
+            total_mW += calculate_unscaled_power_mW( pCur->leds5b(), pCur->size());
+        } else if( pCur->brightnessData()) {
+            total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->brightnessData(), pCur->size());
+        } else if( pCur->leds()) {
+            total_mW += calculate_unscaled_power_mW( pCur->leds(), pCur->size());
+        }
 		pCur = pCur->next();
 	}
 
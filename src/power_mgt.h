@@ -58,6 +58,12 @@ void delay_at_max_brightness_for_power( uint16_t ms);
 ///
 uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 
+/// calculate_unscaled_power_mW for leds with a per pixel 5 bit brightness
+///   (APA102WB), either interleaved CRGB5b data or CRGB data plus a separate
+///   brightness array.  Each pixel's colors are weighted by brt/31.
+uint32_t calculate_unscaled_power_mW( const CRGB5b* ledbuffer, uint16_t numLeds);
+uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, const uint8_t* bdata, uint16_t numLeds);
+
 /// calculate_max_brightness_for_power_mW tells you the highest brightness
 ///   level you can use and still stay under the specified power budget for 
 ///   a given set of leds.  It takes a pointer to an array of CRGB objects, a
@@ -66,6 +72,12 @@ uint32_t calculate_unscaled_power_mW( const CRGB* ledbuffer, uint16_t numLeds);
 ///   this function will be no higher than the target_brightess you supply, but may be lower.
 uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW);
 
+/// calculate_max_brightness_for_power_mW for leds with a per pixel 5 bit
+///   brightness, either interleaved CRGB5b data or CRGB data plus a separate
+///   brightness array.
+uint8_t calculate_max_brightness_for_power_mW(const CRGB5b* ledbuffer, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW);
+uint8_t calculate_max_brightness_for_power_mW(const CRGB* ledbuffer, const uint8_t* bdata, uint16_t numLeds, uint8_t target_brightness, uint32_t max_power_mW);
+
 /// calculate_max_brightness_for_power_mW tells you the highest brightness
 ///   level you can use and still stay under the specified power budget for 
 ///   a given set of leds.  It takes a pointer to an array of CRGB objects, a
@@ -78,7 +90,8 @@ uint8_t calculate_max_brightness_for_power_vmA(const CRGB* ledbuffer, uint16_t n
 ///   level you can use and still stay under the specified power budget.  It
 ///   takes a 'target brightness' which is the brightness you'd ideally like
 ///   to use.  The result from this function will be no higher than the
-///   target_brightess you supply, but may be lower.
+///   target_brightess you supply, but may be lower.  Controllers with per
+///   pixel brightness data are measured with it.
 uint8_t  calculate_max_brightness_for_power_mW( uint8_t target_brightness, uint32_t max_power_mW);
 
 FASTLED_NAMESPACE_END
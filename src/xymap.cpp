@@ -0,0 +1,53 @@
+#define FASTLED_INTERNAL
+#include "FastLED.h"
+#include "xymap.h"
+
+FASTLED_NAMESPACE_BEGIN
+
+// where (x,y) is among the leds of a width x height block laid out in layout
+static uint32_t layoutIndex(EXYLayout layout, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	switch(layout) {
+		case XY_SERPENTINE: return ((uint32_t)y * width) + ((y & 0x01) ? (width - 1 - x) : x);
+		case XY_COLUMNS: return ((uint32_t)x * height) + y;
+		case XY_COLUMNS_SERPENTINE: return ((uint32_t)x * height) + ((x & 0x01) ? (height - 1 - y) : y);
+		default: return ((uint32_t)y * width) + x;
+	}
+}
+
+XYMap::XYMap(uint16_t width, uint16_t height, EXYLayout layout, uint16_t *table)
+	: mWidth(width), mHeight(height), mTable(NULL) {
+	if(layout == XY_ROWS) { return; }
+	for(uint16_t y = 0; y < height; ++y) {
+		uint16_t *row = table + ((uint32_t)y * width);
+		for(uint16_t x = 0; x < width; ++x) { row[x] = (uint16_t)layoutIndex(layout, x, y, width, height); }
+	}
+	mTable = table;
+}
+
+XYMap::XYMap(uint16_t width, uint16_t height, uint16_t panelWidth, uint16_t panelHeight,
+             EXYLayout panelLayout, EXYLayout panelOrder, uint16_t *table)
+	: mWidth(width), mHeight(height), mTable(table) {
+	uint16_t panelsWide = width / panelWidth;
+	uint16_t panelsHigh = height / panelHeight;
+	uint32_t panelLeds = (uint32_t)panelWidth * panelHeight;
+	for(uint16_t y = 0; y < height; ++y) {
+		uint16_t *row = table + ((uint32_t)y * width);
+		uint16_t py = y / panelHeight;
+		uint16_t ly = y % panelHeight;
+		for(uint16_t x = 0; x < width; ++x) {
+			uint32_t panel = layoutIndex(panelOrder, x / panelWidth, py, panelsWide, panelsHigh);
+			row[x] = (uint16_t)((panel * panelLeds) + layoutIndex(panelLayout, x % panelWidth, ly, panelWidth, panelHeight));
+		}
+	}
+}
+
+void XYMap::outputMap(uint16_t *map) const {
+	for(uint16_t y = 0; y < mHeight; ++y) {
+		for(uint16_t x = 0; x < mWidth; ++x) {
+			uint16_t xy = (uint16_t)(((uint32_t)y * mWidth) + x);
+			map[(*this)(x, y)] = xy;
+		}
+	}
+}
+
+FASTLED_NAMESPACE_END
@@ -0,0 +1,92 @@
+#ifndef __INC_XYMAP_H
+#define __INC_XYMAP_H
+
+#include "FastLED.h"
+
+///@file xymap.h
+/// Where each (x,y) of a matrix is in the leds array, worked out once rather than by calling an XY() function for
+/// every led of every frame.  A map is a width, a height and a table of uint16_t led indices, one per (x,y) in rows
+/// of width entries, so looking up a led is a single load.  Leds laid out in rows, one after another, need no table
+/// at all, and the 2d functions that take a map (blur2d, blurRows, blurColumns, fill_2dnoise8, fill_2dnoise16) skip
+/// the lookup altogether for them.
+///
+///     // a serpentine 32x16 matrix, with the table alongside the map
+///     XYMapBuffer<32, 16> xymap(XY_SERPENTINE);
+///     blur2d(leds, xymap, 64);
+///     leds[xymap(x, y)] = CRGB::Red;
+///
+///     // a table that's already in flash or ram, used in place
+///     XYMap xymap(16, 16, myTable);
+///
+/// Every (x,y) must be a different led, and a map covers up to 65536 leds.
+
+FASTLED_NAMESPACE_BEGIN
+
+/// Ways of laying leds out in a matrix (or panels in a grid of panels), each starting from (0,0)
+enum EXYLayout {
+	XY_ROWS,               ///< each row left to right, one after another: (x,y) is led y * width + x
+	XY_SERPENTINE,         ///< rows alternating direction, odd rows going right to left
+	XY_COLUMNS,            ///< each column top to bottom, one after another: (x,y) is led x * height + y
+	XY_COLUMNS_SERPENTINE  ///< columns alternating direction, odd columns going bottom to top
+};
+
+/// A width x height matrix and where each (x,y) of it is in the leds array.  The map doesn't own its table, so the
+/// table must outlast it - XYMapBuffer below keeps the two together.
+class XYMap {
+	uint16_t mWidth;
+	uint16_t mHeight;
+	const uint16_t *mTable;   // led index of each (x,y), in rows of mWidth; NULL for XY_ROWS
+
+public:
+	/// leds in rows, (x,y) at led y * width + x, with no table
+	XYMap(uint16_t width, uint16_t height) : mWidth(width), mHeight(height), mTable(NULL) {}
+
+	/// any layout at all, (x,y) at led table[y * width + x].  The table is used in place, not copied.
+	XYMap(uint16_t width, uint16_t height, const uint16_t *table) : mWidth(width), mHeight(height), mTable(table) {}
+
+	/// one of the layouts above, written into table, which needs width * height entries (and isn't used for XY_ROWS)
+	XYMap(uint16_t width, uint16_t height, EXYLayout layout, uint16_t *table);
+
+	/// a grid of panels of panelWidth x panelHeight leds each, wired one after another: the panels are in panelOrder,
+	/// and the leds on each panel are in panelLayout.  width and height must be whole numbers of panels.  Written
+	/// into table, which needs width * height entries.
+	XYMap(uint16_t width, uint16_t height, uint16_t panelWidth, uint16_t panelHeight,
+	      EXYLayout panelLayout, EXYLayout panelOrder, uint16_t *table);
+
+	uint16_t width() const { return mWidth; }
+	uint16_t height() const { return mHeight; }
+	/// number of leds the map covers
+	uint32_t size() const { return (uint32_t)mWidth * mHeight; }
+	/// the table, in rows of width() entries, or NULL when the leds are in rows and there's no table
+	const uint16_t *table() const { return mTable; }
+
+	/// write out the inverse of this map: for each led, the row-major index (y * width + x) of the (x,y) it's at.
+	/// Used as a controller's output map (see CLEDController::setOutputMap) it lets the leds be drawn in plain rows
+	/// and written out in this map's order.  map needs size() entries.
+	void outputMap(uint16_t *map) const;
+
+	/// the led at (x,y)
+	uint32_t operator()(uint16_t x, uint16_t y) const {
+		uint32_t xy = ((uint32_t)y * mWidth) + x;
+		return mTable ? mTable[xy] : xy;
+	}
+};
+
+/// An XYMap for a WIDTH x HEIGHT matrix, with room for its table alongside
+template<uint16_t WIDTH, uint16_t HEIGHT>
+class XYMapBuffer : public XYMap {
+	uint16_t mEntries[WIDTH * HEIGHT];
+
+public:
+	XYMapBuffer(EXYLayout layout) : XYMap(WIDTH, HEIGHT) {
+		*(XYMap*)this = XYMap(WIDTH, HEIGHT, layout, mEntries);
+	}
+
+	XYMapBuffer(uint16_t panelWidth, uint16_t panelHeight, EXYLayout panelLayout, EXYLayout panelOrder) : XYMap(WIDTH, HEIGHT) {
+		*(XYMap*)this = XYMap(WIDTH, HEIGHT, panelWidth, panelHeight, panelLayout, panelOrder, mEntries);
+	}
+};
+
+FASTLED_NAMESPACE_END
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef __INC_HOST_TEST_H
+#define __INC_HOST_TEST_H
+
+// Shared bits of the host platform tests: each test is a program that prints what fails and returns nonzero if
+// anything did.  See ci/host-tests.
+
+#include <FastLED.h>
+#include <stdio.h>
+
+FASTLED_USING_NAMESPACE
+
+static int gFailures = 0;
+
+#define CHECK(cond) do { if(!(cond)) { ++gFailures; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while(0)
+
+static int testResult(const char *name) {
+  printf("%s: %s\n", name, gFailures ? "FAILED" : "ok");
+  return gFailures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,105 @@
+// APA102WB driven from interleaved CRGB5b data must put the same stream on the wire as from split CRGB and
+// brightness arrays, and that stream must be the one the APA102 datasheet describes.
+
+#include "host_test.h"
+#include <vector>
+
+#define NUM_LEDS 40
+
+CRGB leds[NUM_LEDS];
+uint8_t brightness[NUM_LEDS];
+CRGB5b leds5b[NUM_LEDS];
+
+// the wire stream for leds5b at the color adjustment adj, in dither cycle step R: init_binary_dithering's offsets,
+// added to each non-zero channel before scaling and flipped between d and e - d from one led to the next
+static std::vector<uint8_t> dithered(CRGB adj, uint8_t R) {
+  R &= (1 << VIRTUAL_BITS) - 1;
+  uint8_t Q = 0;
+  for(int bit = 0; bit < 8; ++bit) { if(R & (1 << bit)) { Q |= 0x80 >> bit; } }
+  Q += 0x01 << (7 - VIRTUAL_BITS);
+  uint8_t d[3], e[3];
+  for(int i = 0; i < 3; ++i) {
+    e[i] = adj.raw[i] ? (256 / adj.raw[i]) + 1 : 0;
+    d[i] = scale8(Q, e[i]);
+#if (FASTLED_SCALE8_FIXED == 1)
+    if(d[i]) { --d[i]; }
+#endif
+    if(e[i]) { --e[i]; }
+  }
+  std::vector<uint8_t> ref(4, 0);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    ref.push_back(0xE0 | (leds5b[i].brt & 0x1F));
+    for(int c = 2; c >= 0; --c) {
+      uint8_t v = leds5b[i].raw[c];
+      ref.push_back(scale8(v ? qadd8(v, d[c]) : 0, adj.raw[c]));
+    }
+    for(int c = 0; c < 3; ++c) { d[c] = e[c] - d[c]; }
+  }
+  for(int i = 0; i <= NUM_LEDS / 32; ++i) {
+    ref.push_back(0xFF); ref.push_back(0); ref.push_back(0); ref.push_back(0);
+  }
+  return ref;
+}
+
+int main() {
+  CHostClock::useVirtualClock(true);
+  CBrightnessLEDController &split = FastLED.addLeds<APA102WB, 5, 6, BGR, DATA_RATE_MHZ(12)>(leds, brightness, NUM_LEDS);
+  CBrightnessLEDController &packed = FastLED.addLeds<APA102WB, 7, 8, BGR, DATA_RATE_MHZ(12)>(leds5b, NUM_LEDS);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    leds[i] = CRGB(10*i, 20*i, 3*i);
+    brightness[i] = i;
+    leds5b[i] = CRGB5b(10*i, 20*i, 3*i, i);
+  }
+  FastLED.setDither(DISABLE_DITHER);
+  FastLED.setBrightness(200);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.show();
+  CHECK(CHostTrace::bytes(5) == CHostTrace::bytes(7));
+
+  // start frame, then brightness and blue, green, red per led, then the end frame
+  std::vector<uint8_t> ref(4, 0);
+  CRGB adj = packed.getAdjustment(200);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    ref.push_back(0xE0 | (i & 0x1F));
+    ref.push_back(scale8(leds5b[i].b, adj.b));
+    ref.push_back(scale8(leds5b[i].g, adj.g));
+    ref.push_back(scale8(leds5b[i].r, adj.r));
+  }
+  for(int i = 0; i <= NUM_LEDS / 32; ++i) {
+    ref.push_back(0xFF); ref.push_back(0); ref.push_back(0); ref.push_back(0);
+  }
+  CHECK(CHostTrace::bytes(7) == ref);
+
+  // dithered frames still match, and step through init_binary_dithering's cycle: run at 500Hz (400Hz plus the
+  // wire time is too slow for FASTLED_ADAPTIVE_DITHER to use every bit) until dithering is on, then expect three
+  // frames in a row to be three steps in a row of the cycle
+  FastLED.setDither(BINARY_DITHER);
+  for(int f = 0; f < 50; ++f) { FastLED.show(); CHostClock::advance(2000000); }
+  CHECK(packed.getDitherBits() == VIRTUAL_BITS);
+  std::vector<uint8_t> frames[3];
+  for(int f = 0; f < 3; ++f) {
+    CHostTrace::clear();
+    FastLED.show();
+    CHostClock::advance(2000000);
+    frames[f] = CHostTrace::bytes(7);
+    CHECK(CHostTrace::bytes(5) == frames[f]);
+  }
+  CHECK(frames[0] != frames[1] && frames[1] != frames[2]);
+  bool inCycle = false;
+  for(int r = 0; r < (1 << VIRTUAL_BITS); ++r) {
+    inCycle |= frames[0] == dithered(adj, r) && frames[1] == dithered(adj, r + 1) && frames[2] == dithered(adj, r + 2);
+  }
+  CHECK(inCycle);
+
+  // and so do reversed ones, starting with the last led
+  CHostTrace::clear();
+  FastLED.setDither(DISABLE_DITHER);
+  split.setLeds(leds + NUM_LEDS - 1, brightness + NUM_LEDS - 1, -NUM_LEDS);
+  packed.setLeds(leds5b + NUM_LEDS - 1, -NUM_LEDS);
+  FastLED.show();
+  std::vector<uint8_t> reversed = CHostTrace::bytes(7);
+  CHECK(CHostTrace::bytes(5) == reversed);
+  CHECK(reversed.size() == ref.size() && reversed[4] == (0xE0 | ((NUM_LEDS - 1) & 0x1F)));
+
+  return testResult("apa102wb");
+}
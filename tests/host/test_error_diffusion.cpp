@@ -0,0 +1,75 @@
+// ERROR_DIFFUSION_DITHER carries what each pixel loses to rounding into the next frame: every frame's output is the
+// exact scaled value rounded down or up, and averaged over a few frames it comes out closer to the exact value than
+// binary dithering does.
+// host-test-flags: -DFASTLED_ERROR_DIFFUSION=1
+
+#include "host_test.h"
+#include <math.h>
+
+#define NUM_LEDS 256
+#define NUM_FRAMES 256
+#define WARMUP_FRAMES 16
+
+CRGB leds[NUM_LEDS];
+
+// show NUM_FRAMES frames at 800Hz of virtual time, fast enough for DIFFUSION_BITS with FASTLED_ADAPTIVE_DITHER, and
+// return the mean over the leds of how far the average output is from the exact scaled value.  Counts frames with
+// any channel a step or more away from it in bad.
+static double meanError(uint8_t ditherMode, uint8_t scale, int & bad) {
+  FastLED.setDither(ditherMode);
+  FastLED.setBrightness(scale);
+  static double sum[NUM_LEDS * 3];
+  for(int i = 0; i < NUM_LEDS * 3; ++i) { sum[i] = 0; }
+  for(int f = 0; f < WARMUP_FRAMES + NUM_FRAMES; ++f) {
+    uint64_t start = CHostClock::nanos();
+    FastLED.show();
+    CHostClock::advance(1250000 - (CHostClock::nanos() - start));
+    if(f < WARMUP_FRAMES) { continue; }
+    const CHostTrace::Transfer *t = CHostTrace::last(3);
+    CHECK(t != NULL && t->bytes.size() == NUM_LEDS * 3);
+    if(t == NULL || t->bytes.size() != NUM_LEDS * 3) { return 1000; }
+    bool frameBad = false;
+    for(int i = 0; i < NUM_LEDS * 3; ++i) {
+      double exact = leds[i / 3].raw[i % 3] * (scale + 1) / 256.0;
+      if(fabs(t->bytes[i] - exact) >= 1) { frameBad = true; }
+      sum[i] += t->bytes[i];
+    }
+    if(frameBad) { ++bad; }
+  }
+  double err = 0;
+  for(int i = 0; i < NUM_LEDS * 3; ++i) {
+    double exact = leds[i / 3].raw[i % 3] * (scale + 1) / 256.0;
+    err += fabs(sum[i] / NUM_FRAMES - exact);
+  }
+  return err / (NUM_LEDS * 3);
+}
+
+int main() {
+  CHostClock::useVirtualClock(true);
+  FastLED.addLeds<WS2812B, 3, RGB>(leds, NUM_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  // a dim gradient, where rounding loses the most
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(1 + (i & 63), 1 + ((i * 3) & 63), i >> 2); }
+
+  static const uint8_t scales[] = { 16, 60, 200 };
+  for(unsigned s = 0; s < sizeof(scales); ++s) {
+    int bad = 0;
+    double binary = meanError(BINARY_DITHER, scales[s], bad);
+    bad = 0;
+    double diffusion = meanError(ERROR_DIFFUSION_DITHER, scales[s], bad);
+    CHECK(bad == 0);
+    CHECK(diffusion < 0.05);
+    CHECK(diffusion < binary);
+    CHECK(FastLED[0].getDitherBits() == DIFFUSION_BITS);
+  }
+
+  // black stays black
+  FastLED.setBrightness(0);
+  FastLED.show();
+  const CHostTrace::Transfer *t = CHostTrace::last(3);
+  bool black = (t != NULL);
+  for(size_t i = 0; black && i < t->bytes.size(); ++i) { black = (t->bytes[i] == 0); }
+  CHECK(black);
+
+  return testResult("error_diffusion");
+}
@@ -0,0 +1,61 @@
+// hdr16to5b must give every pixel the smallest brightness that holds its brightest channel, and bring every channel
+// back within 0.6 of an 8 bit step at that brightness, as colorutils.h promises.
+
+#include "host_test.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_LEDS 65535
+
+CRGB16 src[NUM_LEDS];
+CRGB5b dest[NUM_LEDS];
+
+// random colors, each shifted down by up to 16 bits so the dim brightnesses are covered as well as the bright ones
+static void randomColors(int seed) {
+  srand(seed);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    int shift = rand() % 17;
+    src[i] = CRGB16((rand() % 65536) >> shift, (rand() % 65536) >> shift, (rand() % 65536) >> shift);
+  }
+}
+
+// every value of one channel, with the other two following it
+static void rampColors() {
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    src[i] = CRGB16(i, i / 3, (65535 - i > i) ? i / 7 : i);
+  }
+}
+
+static double checkColors() {
+  hdr16to5b(src, dest, NUM_LEDS);
+  double worst = 0;
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    uint8_t brt = dest[i].brt;
+    uint16_t top = src[i].r;
+    if(src[i].g > top) { top = src[i].g; }
+    if(src[i].b > top) { top = src[i].b; }
+    if(top == 0) { CHECK(brt == 0); continue; }
+    CHECK(brt >= 1 && brt <= 31);
+    // one less would not have held the brightest channel
+    CHECK(brt == 1 || top * 31.0 / 65535 > brt - 1);
+    double step = 65535.0 * brt / (255 * 31);
+    for(int c = 0; c < 3; ++c) {
+      double err = fabs(dest[i].raw[c] * step - src[i].raw[c]) / step;
+      if(err > worst) { worst = err; }
+    }
+    CRGB5b one = hdr16to5b(src[i]);
+    CHECK(memcmp(&one, &dest[i], sizeof(one)) == 0);
+  }
+  return worst;
+}
+
+int main() {
+  for(int seed = 1; seed <= 16; ++seed) {
+    randomColors(seed);
+    CHECK(checkColors() <= 0.6);
+  }
+  rampColors();
+  CHECK(checkColors() <= 0.6);
+  return testResult("hdr16to5b");
+}
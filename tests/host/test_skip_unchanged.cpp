@@ -0,0 +1,73 @@
+// FastLED.show with FASTLED_SKIP_UNCHANGED must leave out controllers whose frame hasn't changed, except that
+// controllers sent in one batch (like the ESP32 RMT and I2S drivers) go out together or not at all.
+// host-test-flags: -DFASTLED_SKIP_UNCHANGED=1
+
+#include "host_test.h"
+
+#define NUM_LEDS 16
+
+// A controller that works the way the ESP32 RMT driver does: each one's frame is only sent once all of them have
+// been shown, and until then the batch is held open.
+static int gNumControllers = 0;
+static int gNumStarted = 0;
+static int gBatchesSent = 0;
+
+class BatchController : public CPixelLEDController<RGB> {
+public:
+  int mFramesSent;
+  BatchController() : mFramesSent(0) { ++gNumControllers; }
+  virtual void init() { }
+  virtual bool showsInBatch() const { return true; }
+
+protected:
+  virtual void showPixels(PixelController<RGB> & pixels) {
+    while(pixels.has(1)) { pixels.advanceData(); }
+    if(++gNumStarted == gNumControllers) {
+      ++gBatchesSent;
+      gNumStarted = 0;
+    }
+    ++mFramesSent;
+  }
+};
+
+CRGB batchLeds[2][NUM_LEDS];
+CRGB plainLeds[2][NUM_LEDS];
+BatchController batch[2];
+
+int main() {
+  FastLED.addLeds(&batch[0], batchLeds[0], NUM_LEDS);
+  FastLED.addLeds(&batch[1], batchLeds[1], NUM_LEDS);
+  FastLED.addLeds<WS2812B, 3, GRB>(plainLeds[0], NUM_LEDS);
+  FastLED.addLeds<WS2812B, 4, GRB>(plainLeds[1], NUM_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setDither(DISABLE_DITHER);
+  FastLED.show();
+  CHECK(gBatchesSent == 1 && gNumStarted == 0);
+
+  // nothing changed: everything is skipped, and the batch isn't left half started
+  CHostTrace::clear();
+  FastLED.show();
+  CHECK(gBatchesSent == 1 && gNumStarted == 0);
+  CHECK(CHostTrace::transfers().size() == 0);
+  CHECK(FastLED.getSkippedFrames() == 4);
+
+  // one of the batch changed: both of the batch go out, so the batch is sent, and the unchanged plain one stays out
+  for(int f = 0; f < 3; ++f) {
+    batchLeds[0][5] = CRGB(f + 1, 2, 3);
+    plainLeds[1][2] = CRGB(f + 1, 5, 6);
+    CHostTrace::clear();
+    FastLED.show();
+    CHECK(gBatchesSent == 2 + f && gNumStarted == 0);
+    CHECK(batch[0].mFramesSent == 2 + f && batch[1].mFramesSent == 2 + f);
+    CHECK(CHostTrace::transfers().size() == 1 && CHostTrace::last(4) != NULL);
+  }
+  CHECK(FastLED.getSkippedFrames() == 4 + 3);
+
+  // and the same through showAsync
+  batchLeds[1][0] = CRGB::Red;
+  FastLED.showAsync();
+  FastLED.waitShowComplete();
+  CHECK(gBatchesSent == 5 && gNumStarted == 0);
+
+  return testResult("skip_unchanged");
+}
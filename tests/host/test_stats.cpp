@@ -0,0 +1,58 @@
+// FASTLED_STATS: FastLED.getStats counts the frames, the time spent showing and throttling, and the frame intervals,
+// and each controller's getStats the time its own output took.
+// host-test-flags: -DFASTLED_STATS=1
+
+#include "host_test.h"
+
+#define NUM_LEDS 300
+
+CRGB ws2812Leds[NUM_LEDS];
+CRGB apa102Leds[NUM_LEDS];
+
+int main() {
+  CHostClock::useVirtualClock(true);
+  FastLED.addLeds<WS2812B, 3, GRB>(ws2812Leds, NUM_LEDS);
+  FastLED.addLeds<APA102, 5, 6, BGR, DATA_RATE_MHZ(12)>(apa102Leds, NUM_LEDS);
+  FastLED.setMaxRefreshRate(100);
+
+  // 20 frames at the 100Hz limit, with one 70ms stall, and one through showAsync.  Every frame is different, so that
+  // none are left out with FASTLED_SKIP_UNCHANGED.
+  for(int f = 0; f < 20; ++f) {
+    if(f == 10) { CHostClock::advance(70000000); }
+    ws2812Leds[0] = apa102Leds[0] = CRGB(f, 0, 0);
+    FastLED.show();
+  }
+  ws2812Leds[0] = apa102Leds[0] = CRGB::Blue;
+  FastLED.showAsync();
+  FastLED.waitShowComplete();
+
+  const CFastLEDStats & stats = FastLED.getStats();
+  CHECK(stats.frames == 21);
+  CHECK(stats.intervals == 20);
+  CHECK(stats.minFrameMicros == 10000);
+  CHECK(stats.maxFrameMicros >= 70000);
+  CHECK(stats.avgFrameMicros() == stats.totalFrameMicros / 20);
+  CHECK(stats.throttleMicros > 0 && stats.throttleMicros < stats.showMicros);
+  uint32_t counted = 0;
+  for(int i = 0; i < FASTLED_STATS_BUCKETS; ++i) { counted += stats.histogram[i]; }
+  CHECK(counted == 20);
+  CHECK(stats.histogram[4] == 19);                          // 8 to 16ms
+  CHECK(stats.histogram[FASTLED_STATS_BUCKETS - 1] == 1);   // the stall
+
+  // each 300 led WS2812B frame is 9ms on the wire, and the host output is held up for it; the APA102 at 12MHz is
+  // much quicker
+  const CLEDStats & ws2812 = FastLED[0].getStats();
+  const CLEDStats & apa102 = FastLED[1].getStats();
+  CHECK(ws2812.frames == 21 && apa102.frames == 21);
+  CHECK(ws2812.transmitMicros >= 21 * 9000);
+  CHECK(apa102.transmitMicros > 0 && apa102.transmitMicros < ws2812.transmitMicros / 4);
+  CHECK(ws2812.retries == 0 && apa102.retries == 0);
+
+  FastLED.resetStats();
+  ws2812Leds[0] = apa102Leds[0] = CRGB::Green;
+  FastLED.show();
+  CHECK(stats.frames == 1);
+  CHECK(FastLED[0].getStats().frames == 1 && FastLED[1].getStats().frames == 1);
+
+  return testResult("stats");
+}
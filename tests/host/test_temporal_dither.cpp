@@ -0,0 +1,64 @@
+// With FASTLED_ADAPTIVE_DITHER, each controller sizes its dither cycle from its own frame interval: the faster a
+// strip is refreshed, the more bits it dithers with, and a whole cycle never takes longer than about 20ms, so the
+// output averaged over any 20ms (what the eye sees at 50Hz) stays close to the exact scaled value.
+// host-test-flags: -DFASTLED_ADAPTIVE_DITHER=1
+
+#include "host_test.h"
+#include <math.h>
+
+#define NUM_LEDS 8
+#define NUM_FRAMES 400
+
+CRGB leds[NUM_LEDS];
+static const uint8_t vals[NUM_LEDS] = { 1, 3, 7, 20, 33, 77, 130, 201 };
+
+// show NUM_FRAMES frames, one every interval us of virtual time, and return the worst error of the output averaged
+// over any 20ms window, once the frame interval has settled.  The output of a frame is what's on the leds after it,
+// which is the last frame written out if this one was left out (see FASTLED_SKIP_UNCHANGED).
+static double worstError(int interval, uint8_t scale) {
+  static uint8_t output[NUM_FRAMES][NUM_LEDS];
+  for(int f = 0; f < NUM_FRAMES; ++f) {
+    uint64_t start = CHostClock::nanos();
+    FastLED.show();
+    CHostClock::advance((uint64_t)interval * 1000 - (CHostClock::nanos() - start));
+    const CHostTrace::Transfer *t = CHostTrace::last(3);
+    CHECK(t != NULL && t->bytes.size() == NUM_LEDS * 3);
+    if(t == NULL || t->bytes.size() != NUM_LEDS * 3) { return 1000; }
+    for(int i = 0; i < NUM_LEDS; ++i) { output[f][i] = t->bytes[i * 3]; }
+  }
+
+  int window = (20000 + interval - 1) / interval;
+  double worst = 0;
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    double exact = vals[i] * (scale + 1) / 256.0;
+    for(int s = NUM_FRAMES / 2; s + window <= NUM_FRAMES; ++s) {
+      double sum = 0;
+      for(int k = 0; k < window; ++k) { sum += output[s + k][i]; }
+      double err = fabs(sum / window - exact);
+      if(err > worst) { worst = err; }
+    }
+  }
+  return worst;
+}
+
+int main() {
+  CHostClock::useVirtualClock(true);
+  FastLED.addLeds<WS2812B, 3, RGB>(leds, NUM_LEDS);
+  FastLED.setMaxRefreshRate(0);
+  for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = CRGB(vals[i], vals[i], vals[i]); }
+
+  static const int intervals[] = { 1250, 2500, 5000, 10000, 16666, 25000 };
+  static const uint8_t bits[] = { 3, 3, 2, 1, 0, 0 };
+  static const uint8_t scales[] = { 16, 40, 100, 200 };
+  for(unsigned s = 0; s < sizeof(scales); ++s) {
+    FastLED.setBrightness(scales[s]);
+    for(unsigned i = 0; i < sizeof(bits); ++i) {
+      double worst = worstError(intervals[i], scales[s]);
+      CHECK(FastLED[0].getDitherBits() == bits[i]);
+      // undithered, the output is off by up to a whole step; dithered, by less than the best plain rounding
+      CHECK(worst < (bits[i] ? 0.6 : 1.0));
+    }
+  }
+
+  return testResult("temporal_dither");
+}
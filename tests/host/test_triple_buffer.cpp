@@ -0,0 +1,107 @@
+// Frame buffers hand whole frames from a drawing thread to FastLED.show on another: every frame shown must be one
+// the drawing side published complete (no mix of two frames, no torn per pixel brightness), frames must never go
+// backwards, and the newest one must be shown once drawing stops.
+// host-test-flags: -DFASTLED_TRIPLE_BUFFER=1
+
+#include "host_test.h"
+#include <thread>
+#include <atomic>
+
+#define NUM_LEDS 300
+#define NUM_FRAMES 20000
+
+CFrameBuffer<CRGB, NUM_LEDS> rgbFrames;
+CFrameBuffer<CRGB, NUM_LEDS, true> brightnessFrames;
+CFrameBuffer<CRGB5b, NUM_LEDS> rgb5bFrames;
+std::atomic<uint32_t> gPublished(0);
+std::atomic<bool> gDone(false);
+
+// each frame is all leds set to its number, with the low 5 bits of it as the brightness
+static CRGB frameColor(uint32_t n) { return CRGB(n & 0xFF, (n >> 8) & 0xFF, (n >> 16) & 0xFF); }
+static uint32_t frameNumber(uint8_t r, uint8_t g, uint8_t b) { return r | (g << 8) | ((uint32_t)b << 16); }
+
+static void draw() {
+  for(uint32_t n = 1; n <= NUM_FRAMES; ++n) {
+    CRGB c = frameColor(n);
+    CRGB *rgb = rgbFrames.back();
+    for(int i = 0; i < NUM_LEDS; ++i) { rgb[i] = c; }
+    rgbFrames.publish();
+    CRGB *leds = brightnessFrames.back();
+    uint8_t *brightness = brightnessFrames.backBrightness();
+    for(int i = 0; i < NUM_LEDS; ++i) { leds[i] = c; brightness[i] = n & 31; }
+    brightnessFrames.publish();
+    CRGB5b *rgb5b = rgb5bFrames.back();
+    for(int i = 0; i < NUM_LEDS; ++i) { rgb5b[i] = CRGB5b(c.r, c.g, c.b, n & 31); }
+    rgb5bFrames.publish();
+    gPublished.store(n);
+  }
+  gDone = true;
+}
+
+// the frame number of the controller's led data, or 0 if it isn't a whole frame
+static uint32_t shownFrame(CLEDController & controller) {
+  uint32_t n = 0;
+  CRGB5b *rgb5b = controller.leds5b();
+  if(rgb5b) {
+    n = frameNumber(rgb5b[0].r, rgb5b[0].g, rgb5b[0].b);
+    for(int i = 0; i < NUM_LEDS; ++i) {
+      if(frameNumber(rgb5b[i].r, rgb5b[i].g, rgb5b[i].b) != n || rgb5b[i].brt != (n & 31)) { return 0; }
+    }
+    return n;
+  }
+  CRGB *leds = controller.leds();
+  n = frameNumber(leds[0].r, leds[0].g, leds[0].b);
+  for(int i = 0; i < NUM_LEDS; ++i) {
+    if(frameNumber(leds[i].r, leds[i].g, leds[i].b) != n) { return 0; }
+  }
+  uint8_t *brightness = controller.brightnessData();
+  if(brightness) {
+    for(int i = 0; i < NUM_LEDS; ++i) {
+      if(brightness[i] != (n & 31)) { return 0; }
+    }
+  }
+  return n;
+}
+
+int main() {
+  CLEDController & rgb = FastLED.addLeds<WS2812B, 3, RGB>(rgbFrames.front(), NUM_LEDS).setLeds(rgbFrames);
+  CLEDController & withBrightness = FastLED.addLeds<APA102WB, 7, 8, RGB>(brightnessFrames.front(), brightnessFrames.frontBrightness(), NUM_LEDS);
+  withBrightness.setLeds(brightnessFrames);
+  CBrightnessLEDController & rgb5b = FastLED.addLeds<APA102WB, 9, 10, RGB>(rgb5bFrames.front(), NUM_LEDS);
+  rgb5b.setLeds(rgb5bFrames);
+  FastLED.setMaxRefreshRate(0);
+  FastLED.setDither(DISABLE_DITHER);
+  CHostTrace::enable(false);
+
+  std::thread drawing(draw);
+  CLEDController *controllers[3] = { &rgb, &withBrightness, &rgb5b };
+  uint32_t last[3] = { 0, 0, 0 };
+  int torn = 0, backwards = 0, shows = 0;
+  while(!gDone) {
+    uint32_t before = gPublished;
+    FastLED.show();
+    // one more frame than had been counted may be out, as the count follows the publish
+    uint32_t after = gPublished + 1;
+    for(int c = 0; c < 3; ++c) {
+      uint32_t n = shownFrame(*controllers[c]);
+      if(n == 0 && (before != 0 || last[c] != 0)) { ++torn; continue; }
+      if(n < last[c] || n + 1 < before || n > after) { ++backwards; }
+      last[c] = n;
+    }
+    ++shows;
+  }
+  drawing.join();
+  CHECK(torn == 0);
+  CHECK(backwards == 0);
+  CHECK(shows > 0);
+
+  // drawing has stopped: the next show takes the last frame published, and what goes out on the wire is it
+  CHostTrace::enable(true);
+  FastLED.show();
+  for(int c = 0; c < 3; ++c) { CHECK(shownFrame(*controllers[c]) == NUM_FRAMES); }
+  std::vector<uint8_t> wire = CHostTrace::bytes(3);
+  CHECK(wire.size() == 3 * NUM_LEDS);
+  if(wire.size() == 3 * NUM_LEDS) { CHECK(frameNumber(wire[0], wire[1], wire[2]) == NUM_FRAMES); }
+
+  return testResult("triple_buffer");
+}
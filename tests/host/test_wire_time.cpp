@@ -0,0 +1,38 @@
+// CLEDController::getWireMicros models how long a frame takes on the wire: it should match the timing of the frame
+// the host platform actually sends, plus the latch time for clockless leds.
+
+#include "host_test.h"
+
+#define NUM_LEDS 300
+
+CRGB ws2812Leds[NUM_LEDS];
+CRGB apa102Leds[NUM_LEDS];
+
+static bool near(uint32_t a, uint32_t b) { return (a > b ? a - b : b - a) <= 1; }
+
+int main() {
+  CLEDController & ws2812 = FastLED.addLeds<WS2812B, 3, GRB>(ws2812Leds, NUM_LEDS);
+  CLEDController & apa102 = FastLED.addLeds<APA102, 5, 6, BGR, DATA_RATE_MHZ(12)>(apa102Leds, NUM_LEDS);
+  FastLED.show();
+
+  // clockless: 24 bits of 1.25us per led, then 50us low for the leds to latch
+  const CHostTrace::Transfer *t = CHostTrace::last(3);
+  CHECK(t != NULL);
+  if(t != NULL) {
+    CHECK(t->bytes.size() == NUM_LEDS * 3);
+    CHECK(near(ws2812.getFrameWireMicros(), (uint32_t)(t->wireNs() / 1000) + 50));
+  }
+
+  // spi: the start frame, the leds and the end frame at 12MHz, with nothing to wait for after
+  t = CHostTrace::last(5);
+  CHECK(t != NULL);
+  if(t != NULL) {
+    CHECK(near(apa102.getFrameWireMicros(), (uint32_t)(t->wireNs() / 1000)));
+  }
+
+  uint32_t total = ws2812.getFrameWireMicros() + apa102.getFrameWireMicros();
+  CHECK(FastLED.getWireMicros() == total);
+  CHECK(FastLED.getMaxWireFPS() == 1000000 / total);
+
+  return testResult("wire_time");
+}